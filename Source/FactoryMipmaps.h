@@ -0,0 +1,58 @@
+/*
+  ==============================================================================
+
+    FactoryMipmaps.h
+    Part of WavemorpherSynthesizer project
+
+    Created: 17th October 2026
+    Author:  agent
+
+    Description: The band limited octaves of every factory wavetable, worked
+    out ahead of time by the MipmapGenerator tool and compiled into the plugin
+    as static arrays. The factory tables never change, so at the sample rates
+    below the bank can point its slots straight at this data instead of
+    decoding and transforming each table when it is built. Any other sample
+    rate still builds its octaves at run time.
+
+    FactoryMipmaps.cpp is generated, to remake it after changing a wavetable
+    or the MipmapBuilder, build Tools/MipmapGenerator and run it with the path
+    to Source/FactoryMipmaps.cpp.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+namespace FactoryMipmaps
+{
+    /// Sample rates the octaves are generated for
+    static constexpr double sampleRates[] = { 44100.0, 48000.0 };
+    static constexpr int numSampleRates = (int)(sizeof(sampleRates) / sizeof(sampleRates[0]));
+
+    /// Number of octaves generated for each wavetable, the same as WavescanningSlot builds
+    static constexpr int numOctaves = 10;
+
+    /// Byte alignment of every generated octave
+    static constexpr int alignment = 64;
+
+    //--------------------------------------------------------------------------
+    /// The octaves of one factory wavetable at one sample rate
+    struct Pyramid
+    {
+        /// Name of the wavetable in BinaryData::namedResourceList
+        const char* resourceName;
+
+        /// Sample rate the octaves were built for
+        double sampleRate;
+
+        /// Samples of each octave, with WavetableOscillator::numGuardSamples repeats of the start on the end
+        const float* octaves[numOctaves];
+
+        /// Length of each octave, not counting the guard samples
+        int octaveLengths[numOctaves];
+    };
+
+    /// Every generated pyramid, all of the wavetables at the first sample rate then all of them at the next
+    extern const Pyramid pyramids[];
+    extern const int numPyramids;
+}
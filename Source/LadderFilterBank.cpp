@@ -0,0 +1,210 @@
+/*
+  ==============================================================================
+
+    LadderFilterBank.cpp
+    Part of WavemorpherSynthesizer project
+
+    Created: 17th October 2026
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#include "LadderFilterBank.h"
+
+void LadderFilterBank::prepare(double sampleRate, int maximumBlockSize, int numVoices)
+{
+    // one channel per voice, rounded up so every group is full
+    numGroups = (numVoices + laneWidth - 1) / laneWidth;
+    groups.calloc((size_t)numGroups);
+    voiceChannels.setSize(numGroups * laneWidth, maximumBlockSize);
+    voiceChannels.clear();
+
+    // same constants juce::dsp::LadderFilter works out in setSampleRate and setDrive
+    cutoffFreqScaler = (float)(-2.0 * juce::MathConstants<double>::pi / sampleRate);
+    smoothingLength = juce::jmax(1, (int)std::floor(0.05 * sampleRate));
+
+    gain = std::pow(drive, -2.642f) * 0.6103f + 0.3903f;
+    drive2 = drive * 0.04f + 0.96f;
+    gain2 = std::pow(drive2, -2.642f) * 0.6103f + 0.3903f;
+
+    // start every voice at the juce::dsp::LadderFilter defaults of 200Hz and no resonance
+    for (int group = 0; group < numGroups; group++)
+    {
+        for (int lane = 0; lane < laneWidth; lane++)
+        {
+            auto& g = groups[group];
+            g.cutoffTransform[lane] = g.cutoffTransformTarget[lane] = std::exp(200.0f * cutoffFreqScaler);
+            g.scaledResonance[lane] = g.scaledResonanceTarget[lane] = 0.1f;
+        }
+    }
+
+    reset();
+}
+
+void LadderFilterBank::reset() noexcept
+{
+    for (int group = 0; group < numGroups; group++)
+    {
+        auto& g = groups[group];
+
+        for (int lane = 0; lane < laneWidth; lane++)
+        {
+            for (auto& stage : g.state)
+                stage[lane] = 0.0f;
+
+            // jump straight to the targets
+            g.cutoffTransform[lane] = g.cutoffTransformTarget[lane];
+            g.scaledResonance[lane] = g.scaledResonanceTarget[lane];
+            g.cutoffSamplesLeft[lane] = 0.0f;
+            g.resonanceSamplesLeft[lane] = 0.0f;
+        }
+    }
+}
+
+float* LadderFilterBank::getVoiceChannel(int voice) noexcept
+{
+    return voiceChannels.getWritePointer(voice);
+}
+
+float* const* LadderFilterBank::getVoiceChannels() noexcept
+{
+    return voiceChannels.getArrayOfWritePointers();
+}
+
+void LadderFilterBank::setCutoffFrequencyHz(int voice, float cutoffFrequencyHz) noexcept
+{
+    auto& g = groups[voice / laneWidth];
+    const int lane = voice % laneWidth;
+    const float target = std::exp(cutoffFrequencyHz * cutoffFreqScaler);
+
+    // like juce::SmoothedValue, only start a new ramp when the target actually changes
+    if (target == g.cutoffTransformTarget[lane])
+        return;
+
+    g.cutoffTransformTarget[lane] = target;
+    g.cutoffTransformStep[lane] = (target - g.cutoffTransform[lane]) / (float)smoothingLength;
+    g.cutoffSamplesLeft[lane] = (float)smoothingLength;
+}
+
+void LadderFilterBank::setResonance(int voice, float resonance) noexcept
+{
+    auto& g = groups[voice / laneWidth];
+    const int lane = voice % laneWidth;
+    const float target = juce::jmap(resonance, 0.1f, 1.0f);
+
+    if (target == g.scaledResonanceTarget[lane])
+        return;
+
+    g.scaledResonanceTarget[lane] = target;
+    g.scaledResonanceStep[lane] = (target - g.scaledResonance[lane]) / (float)smoothingLength;
+    g.resonanceSamplesLeft[lane] = (float)smoothingLength;
+}
+
+void LadderFilterBank::jumpToParameters(int voice, float cutoffFrequencyHz, float resonance) noexcept
+{
+    auto& g = groups[voice / laneWidth];
+    const int lane = voice % laneWidth;
+
+    g.cutoffTransform[lane] = g.cutoffTransformTarget[lane] = std::exp(cutoffFrequencyHz * cutoffFreqScaler);
+    g.scaledResonance[lane] = g.scaledResonanceTarget[lane] = juce::jmap(resonance, 0.1f, 1.0f);
+    g.cutoffSamplesLeft[lane] = 0.0f;
+    g.resonanceSamplesLeft[lane] = 0.0f;
+}
+
+void LadderFilterBank::setSmoothingLength(int numSamples) noexcept
+{
+    smoothingLength = juce::jmax(1, numSamples);
+}
+
+void LadderFilterBank::setVoiceActive(int voice, bool isActive) noexcept
+{
+    groups[voice / laneWidth].active[voice % laneWidth] = isActive;
+}
+
+void LadderFilterBank::process(int startSample, int numSamples) noexcept
+{
+    jassert(startSample + numSamples <= voiceChannels.getNumSamples());
+
+    for (int group = 0; group < numGroups; group++)
+    {
+        auto& g = groups[group];
+
+        // nothing to do if none of the group's voices are playing
+        bool anyActive = false;
+
+        for (int lane = 0; lane < laneWidth; lane++)
+            anyActive = anyActive || g.active[lane];
+
+        if (anyActive)
+            processGroup(g, voiceChannels.getArrayOfWritePointers() + group * laneWidth, startSample, numSamples);
+    }
+}
+
+int LadderFilterBank::getNumGroups() const noexcept
+{
+    return numGroups;
+}
+
+void LadderFilterBank::processGroup(int group, int startSample, int numSamples) noexcept
+{
+    jassert(startSample + numSamples <= voiceChannels.getNumSamples());
+
+    processGroup(groups[group], voiceChannels.getArrayOfWritePointers() + group * laneWidth, startSample, numSamples);
+}
+
+void LadderFilterBank::processGroup(LaneGroup& g, float* const* channels, int startSample, int numSamples) noexcept
+{
+    for (int sample = startSample; sample < startSample + numSamples; sample++)
+    {
+        float samples[laneWidth];
+
+        // gather one sample from every voice in the group
+        for (int lane = 0; lane < laneWidth; lane++)
+            samples[lane] = channels[lane][sample];
+
+        // every lane runs the same branch free code, so this loop is done a whole register at a time
+        for (int lane = 0; lane < laneWidth; lane++)
+        {
+            // lanes whose voice isn't playing are worked out along with the rest but keep their old state
+            const bool active = g.active[lane];
+
+            // linear smoothing of the cutoff and resonance, landing exactly on the target like juce::SmoothedValue
+            const float cutoffSamplesLeft = juce::jmax(0.0f, g.cutoffSamplesLeft[lane] - 1.0f);
+            const float cutoffTransform = cutoffSamplesLeft > 0.0f ? g.cutoffTransform[lane] + g.cutoffTransformStep[lane] : g.cutoffTransformTarget[lane];
+            const float resonanceSamplesLeft = juce::jmax(0.0f, g.resonanceSamplesLeft[lane] - 1.0f);
+            const float scaledResonance = resonanceSamplesLeft > 0.0f ? g.scaledResonance[lane] + g.scaledResonanceStep[lane] : g.scaledResonanceTarget[lane];
+
+            // the juce::dsp::LadderFilter model in 24dB low pass mode, an idle lane is fed silence rather than whatever its channel last held
+            const float a1 = cutoffTransform;
+            const float gTerm = 1.0f - a1;
+            const float b0 = gTerm * 0.76923076923f;
+            const float b1 = gTerm * 0.23076923076f;
+
+            const float dx = gain * saturate(drive * (active ? samples[lane] : 0.0f));
+            const float a = dx + scaledResonance * -4.0f * (gain2 * saturate(drive2 * g.state[4][lane]) - dx * comp);
+
+            const float b = b1 * g.state[0][lane] + a1 * g.state[1][lane] + b0 * a;
+            const float c = b1 * g.state[1][lane] + a1 * g.state[2][lane] + b0 * b;
+            const float d = b1 * g.state[2][lane] + a1 * g.state[3][lane] + b0 * c;
+            const float e = b1 * g.state[3][lane] + a1 * g.state[4][lane] + b0 * d;
+
+            g.cutoffSamplesLeft[lane] = active ? cutoffSamplesLeft : g.cutoffSamplesLeft[lane];
+            g.cutoffTransform[lane] = active ? cutoffTransform : g.cutoffTransform[lane];
+            g.resonanceSamplesLeft[lane] = active ? resonanceSamplesLeft : g.resonanceSamplesLeft[lane];
+            g.scaledResonance[lane] = active ? scaledResonance : g.scaledResonance[lane];
+
+            g.state[0][lane] = active ? a : g.state[0][lane];
+            g.state[1][lane] = active ? b : g.state[1][lane];
+            g.state[2][lane] = active ? c : g.state[2][lane];
+            g.state[3][lane] = active ? d : g.state[3][lane];
+            g.state[4][lane] = active ? e : g.state[4][lane];
+
+            samples[lane] = active ? e : 0.0f;
+        }
+
+        // and scatter the filtered samples back
+        for (int lane = 0; lane < laneWidth; lane++)
+            channels[lane][sample] = samples[lane];
+    }
+}
@@ -0,0 +1,200 @@
+/*
+  ==============================================================================
+
+    LadderFilterBank.h
+    Part of WavemorpherSynthesizer project
+
+    Created: 17th October 2026
+    Author:  agent
+
+    Description: Moog style ladder filter for every voice of the synthesiser
+    at once. Uses the same 24dB low pass model as juce::dsp::LadderFilter,
+    but the filter states are stored voice-interleaved (structure of arrays)
+    so the voices in a group are all worked out together, one voice per lane
+    of a SIMD register. Each lane has its own smoothed cutoff and resonance.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/*!
+ @class LadderFilterBank
+ @abstract low pass ladder filter for a whole bank of mono voices
+ @discussion voices write their unfiltered samples into their own channel, the bank filters every channel in place
+
+ @namespace none
+ */
+class LadderFilterBank
+{
+public:
+    /// Voices processed together in one group, one per lane of a SIMD register
+    static constexpr int laneWidth = (int)juce::dsp::SIMDRegister<float>::SIMDNumElements;
+
+    //--------------------------------------------------------------------------
+    /**
+     Allocate the voice channels and filter states, not to be called from the audio thread
+
+     @param sample rate
+     @param maximum number of samples in a block
+     @param number of voices in the bank
+     */
+    void prepare(double sampleRate, int maximumBlockSize, int numVoices);
+
+    //--------------------------------------------------------------------------
+    /**
+     Clear the filter states of every voice
+     */
+    void reset() noexcept;
+
+    //--------------------------------------------------------------------------
+    /**
+     Get the channel a voice writes its unfiltered samples to, filtered in place by process
+
+     @param index of the voice in the bank
+     */
+    float* getVoiceChannel(int voice) noexcept;
+
+    //--------------------------------------------------------------------------
+    /**
+     Get the channels of every voice, indexed the same way as getVoiceChannel
+     */
+    float* const* getVoiceChannels() noexcept;
+
+    //--------------------------------------------------------------------------
+    /**
+     Set the cutoff frequency of one voice's filter, ramped to linearly over the smoothing length
+
+     @param index of the voice in the bank
+     @param cutoff frequency in Hz
+     */
+    void setCutoffFrequencyHz(int voice, float cutoffFrequencyHz) noexcept;
+
+    //--------------------------------------------------------------------------
+    /**
+     Set the resonance of one voice's filter, ramped to linearly over the smoothing length
+
+     @param index of the voice in the bank
+     @param resonance value, between 0 and 1
+     */
+    void setResonance(int voice, float resonance) noexcept;
+
+    //--------------------------------------------------------------------------
+    /**
+     Set the cutoff frequency and resonance of one voice's filter straight away, without ramping
+
+     For a voice starting a note, so it isn't filtered with whatever its last note left behind
+
+     @param index of the voice in the bank
+     @param cutoff frequency in Hz
+     @param resonance value, between 0 and 1
+     */
+    void jumpToParameters(int voice, float cutoffFrequencyHz, float resonance) noexcept;
+
+    //--------------------------------------------------------------------------
+    /**
+     Set how many samples a new cutoff or resonance is ramped to over, 50ms like juce::dsp::LadderFilter until set
+
+     Ramps already under way keep their old length
+
+     @param number of samples
+     */
+    void setSmoothingLength(int numSamples) noexcept;
+
+    //--------------------------------------------------------------------------
+    /**
+     Mark whether a voice has written to its channel this block
+
+     Groups with no voice rendering are skipped altogether, and idle voices in a
+     group that is processed have their filter states and smoothing held and their
+     channel cleared, so a voice's filter picks up where it left off when it plays again
+
+     @param index of the voice in the bank
+     @param true if the voice's channel holds samples to filter
+     */
+    void setVoiceActive(int voice, bool isActive) noexcept;
+
+    //--------------------------------------------------------------------------
+    /**
+     Filter every active group of voices in place
+
+     @param first sample of the voice channels to process
+     @param number of samples to process
+     */
+    void process(int startSample, int numSamples) noexcept;
+
+    //--------------------------------------------------------------------------
+    /**
+     Get the number of groups of laneWidth voices, voice v is in group v / laneWidth
+     */
+    int getNumGroups() const noexcept;
+
+    //--------------------------------------------------------------------------
+    /**
+     Filter one group of voices in place
+
+     Groups share nothing, so different groups can be processed on different threads at once
+
+     @param index of the group
+     @param first sample of the voice channels to process
+     @param number of samples to process
+     */
+    void processGroup(int group, int startSample, int numSamples) noexcept;
+
+private:
+    //--------------------------------------------------------------------------
+    /// Filter states and parameters of laneWidth voices, each array holds one value per lane
+    struct LaneGroup
+    {
+        /// Input and four stages of the ladder
+        float state[5][laneWidth];
+
+        /// Smoothed exp(-2 pi fc / fs), with its per sample step and samples left to smooth
+        float cutoffTransform[laneWidth], cutoffTransformTarget[laneWidth], cutoffTransformStep[laneWidth], cutoffSamplesLeft[laneWidth];
+
+        /// Smoothed resonance scaled to between 0.1 and 1, with its per sample step and samples left to smooth
+        float scaledResonance[laneWidth], scaledResonanceTarget[laneWidth], scaledResonanceStep[laneWidth], resonanceSamplesLeft[laneWidth];
+
+        /// Whether each lane's voice rendered this block
+        bool active[laneWidth];
+    };
+
+    /// Run one group over a block of samples
+    void processGroup(LaneGroup& group, float* const* channels, int startSample, int numSamples) noexcept;
+
+    /// tanh approximation good between -5 and 5, used for the saturation at the input and in the feedback path
+    static forcedinline float saturate(float x) noexcept
+    {
+        x = juce::jlimit(-5.0f, 5.0f, x);
+        const float x2 = x * x;
+        return juce::jlimit(-1.0f, 1.0f, x * (135135.0f + x2 * (17325.0f + x2 * (378.0f + x2)))
+                                            / (135135.0f + x2 * (62370.0f + x2 * (3150.0f + x2 * 28.0f))));
+    }
+
+    //--------------------------------------------------------------------------
+    /// Filter states and parameters, one group per laneWidth voices
+    juce::HeapBlock<LaneGroup> groups;
+
+    /// Number of groups in use
+    int numGroups = 0;
+
+    /// Unfiltered then filtered samples of every voice, one channel per voice rounded up to a whole group
+    juce::AudioBuffer<float> voiceChannels;
+
+    /// -2 pi / sample rate, turns a cutoff in Hz into the filter's exponent
+    float cutoffFreqScaler = 0.0f;
+
+    /// Number of samples the cutoff and resonance are smoothed over
+    int smoothingLength = 1;
+
+    // Input drive and feedback drive with their make up gains, the juce::dsp::LadderFilter defaults
+    static constexpr float drive = 1.2f;
+    float gain = 1.0f;
+    float drive2 = 1.0f;
+    float gain2 = 1.0f;
+
+    /// Feedback compensation for the 24dB low pass mode
+    static constexpr float comp = 0.5f;
+};
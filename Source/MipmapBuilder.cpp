@@ -0,0 +1,133 @@
+/*
+  ==============================================================================
+
+    MipmapBuilder.cpp
+    Part of WavemorpherSynthesizer project
+
+    Created: 17th October 2026
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#include "MipmapBuilder.h"
+#include "WavetableOscillator.h"
+
+MipmapBuilder::MipmapBuilder(double sampleRate)
+{
+    // setting sample rate for later use
+    SR = sampleRate;
+}
+
+void MipmapBuilder::build(const float* cycle, int cycleLength, juce::AudioBuffer<float>* octaves, int numOctaves)
+{
+    jassert(cycleLength > 1);
+
+    const int size = juce::nextPowerOfTwo(cycleLength);
+    prepare(size);
+
+    // the FFT needs a power of two, so anything else is stretched to fit
+    resampleCycle(cycle, cycleLength, source.get(), size);
+
+    // one forward transform for the whole wavetable
+    juce::FloatVectorOperations::clear(spectrum.get(), 2 * size);
+    juce::FloatVectorOperations::copy(spectrum.get(), source.get(), size);
+    getFFT(size).performRealOnlyForwardTransform(spectrum.get());
+
+    for (int octave = 0; octave < numOctaves; octave++)
+    {
+        const int numHarmonics = getNumHarmonics(octave, numOctaves);
+        const int tableSize = getTableSize(numHarmonics, size);
+
+        auto& wavetable = octaves[octave];
+        wavetable.setSize(1, tableSize + WavetableOscillator::numGuardSamples, false, false, true);
+        float* dest = wavetable.getWritePointer(0);
+
+        if (numHarmonics >= size / 2)
+        {
+            // every harmonic in the cycle is below Nyquist on this octave's highest note, nothing to take out
+            juce::FloatVectorOperations::copy(dest, source.get(), size);
+        }
+        else
+        {
+            // only the bins up to the highest harmonic kept, and their mirror images in the negative frequencies,
+            // go into the smaller spectrum, scaled so the inverse transform of the smaller size gives the same levels
+            const float scale = (float)tableSize / (float)size;
+
+            juce::FloatVectorOperations::clear(workspace.get(), 2 * tableSize);
+            juce::FloatVectorOperations::copyWithMultiply(workspace.get(), spectrum.get(), scale, 2 * (numHarmonics + 1));
+            juce::FloatVectorOperations::copyWithMultiply(workspace.get() + 2 * (tableSize - numHarmonics),
+                                                          spectrum.get() + 2 * (size - numHarmonics), scale, 2 * numHarmonics);
+
+            getFFT(tableSize).performRealOnlyInverseTransform(workspace.get());
+            juce::FloatVectorOperations::copy(dest, workspace.get(), tableSize);
+        }
+
+        // repeat the start of the wavetable after its end so the oscillator never has to wrap its index
+        for (int sample = 0; sample < WavetableOscillator::numGuardSamples; sample++)
+            dest[tableSize + sample] = dest[sample];
+    }
+}
+
+int MipmapBuilder::getHighestNote(int octave, int numOctaves) noexcept
+{
+    return octave >= numOctaves - 1 ? 127 : 18 + 12 * octave;
+}
+
+int MipmapBuilder::getNumHarmonics(int octave, int numOctaves) const noexcept
+{
+    const double highestFrequency = 440.0 * std::pow(2.0, (getHighestNote(octave, numOctaves) + bendHeadroom - 69.0) / 12.0);
+
+    // the fundamental is always kept, even if the very top notes bend it past Nyquist
+    return juce::jmax(1, (int)(0.5 * SR / highestFrequency));
+}
+
+void MipmapBuilder::resampleCycle(const float* cycle, int cycleLength, float* dest, int destLength) noexcept
+{
+    if (destLength == cycleLength)
+    {
+        juce::FloatVectorOperations::copy(dest, cycle, destLength);
+        return;
+    }
+
+    // interpolating round the loop, so the last sample leads back into the first
+    for (int i = 0; i < destLength; i++)
+    {
+        const double position = (double)i * cycleLength / destLength;
+        const int n0 = (int)position;
+        const float alpha = (float)(position - n0);
+
+        dest[i] = cycle[n0] + alpha * (cycle[(n0 + 1) % cycleLength] - cycle[n0]);
+    }
+}
+
+int MipmapBuilder::getTableSize(int numHarmonics, int cycleSize) noexcept
+{
+    if (numHarmonics >= cycleSize / 2)
+        return cycleSize;
+
+    // twice over the harmonics' Nyquist, so the interpolation between samples stays accurate
+    return juce::jlimit(juce::jmin(minTableSize, cycleSize), cycleSize, juce::nextPowerOfTwo(4 * numHarmonics));
+}
+
+void MipmapBuilder::prepare(int size)
+{
+    if (size == preparedSize)
+        return;
+
+    preparedSize = size;
+
+    source.calloc((size_t)size);
+    spectrum.calloc((size_t)(2 * size));
+    workspace.calloc((size_t)(2 * size));
+}
+
+juce::dsp::FFT& MipmapBuilder::getFFT(int size)
+{
+    const int order = juce::findHighestSetBit((juce::uint32)size);
+
+    if (ffts[order] == nullptr)
+        ffts[order].reset(new juce::dsp::FFT(order));
+
+    return *ffts[order];
+}
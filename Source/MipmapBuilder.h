@@ -0,0 +1,130 @@
+/*
+  ==============================================================================
+
+    MipmapBuilder.h
+    Part of WavemorpherSynthesizer project
+
+    Created: 17th October 2026
+    Author:  agent
+
+    Description: Builds the band limited octaves ("mipmaps") of a single
+    cycle wavetable in the frequency domain. The cycle is transformed once,
+    then for each octave every harmonic that would land above Nyquist on
+    the highest note the octave is played at is zeroed and the spectrum is
+    transformed back. Unlike low pass filtering the cycle, this leaves the
+    harmonics that are kept untouched in level and phase, wraps cleanly
+    round the loop point and removes everything that could alias.
+    Each octave is transformed back at the smallest power of two length that
+    still holds its harmonics twice over, so the octaves halve in length as
+    they go up and the whole pyramid takes about twice the memory of the
+    cycle, with the high octaves small enough to sit in L1.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/*!
+ @class MipmapBuilder
+ @abstract FFT based generator of the band limited octaves of a wavetable
+ @discussion one forward FFT per wavetable and one inverse FFT per octave that needs harmonics removing
+
+ @namespace none
+ */
+class MipmapBuilder
+{
+public:
+    //--------------------------------------------------------------------------
+    /**
+     Initialization
+
+     @param sample rate the octaves will be played at, which sets where Nyquist is
+     */
+    MipmapBuilder(double sampleRate);
+
+    //--------------------------------------------------------------------------
+    /**
+     Build the band limited octaves of one cycle of a wavetable
+
+     Each octave is a single channel with WavetableOscillator::numGuardSamples
+     copies of its first samples on the end, and a power of two long from the cycle's
+     length down to minTableSize. A cycle whose length isn't a power of two is
+     resampled up to the next one first
+
+     @param samples of one cycle
+     @param number of samples in the cycle
+     @param buffers to write the octaves to, resized as needed
+     @param number of octaves to build
+     */
+    void build(const float* cycle, int cycleLength, juce::AudioBuffer<float>* octaves, int numOctaves);
+
+    //--------------------------------------------------------------------------
+    /**
+     Get the highest midi note an octave is played at
+
+     Octave k is used for the notes from 19 + 12 (k - 1) up to 18 + 12k, the same
+     as the voice picks them, and the last octave for every note above that
+
+     @param index of the octave
+     @param number of octaves built
+     */
+    static int getHighestNote(int octave, int numOctaves) noexcept;
+
+    //--------------------------------------------------------------------------
+    /**
+     Get the number of harmonics an octave can keep without any aliasing
+
+     @param index of the octave
+     @param number of octaves built
+     */
+    int getNumHarmonics(int octave, int numOctaves) const noexcept;
+
+    //--------------------------------------------------------------------------
+    /**
+     Get the length an octave with a number of harmonics is stored at
+
+     @param number of harmonics the octave keeps
+     @param length of the cycle after any resampling to a power of two, the longest an octave can be
+     */
+    static int getTableSize(int numHarmonics, int cycleSize) noexcept;
+
+    //--------------------------------------------------------------------------
+    /**
+     Resample one cycle to a different length by linear interpolation
+
+     @param samples of one cycle
+     @param number of samples in the cycle
+     @param buffer to write the resampled cycle to
+     @param length to resample to
+     */
+    static void resampleCycle(const float* cycle, int cycleLength, float* dest, int destLength) noexcept;
+
+    /// Shortest length an octave is stored at, however few harmonics it has
+    static constexpr int minTableSize = 64;
+
+    /// Semitones above an octave's highest note that are kept alias free, covering a full pitch wheel bend
+    static constexpr float bendHeadroom = 2.0f;
+
+private:
+    //--------------------------------------------------------------------------
+    /// Set up the working memory for cycles of a power of two length
+    void prepare(int size);
+
+    /// Get the FFT for a power of two size, made the first time it is needed
+    juce::dsp::FFT& getFFT(int size);
+
+    //--------------------------------------------------------------------------
+    /// Storing sample rate
+    double SR;
+
+    /// FFT of each power of two size used so far, indexed by its order
+    std::unique_ptr<juce::dsp::FFT> ffts[32];
+
+    /// Cycle length the working memory is allocated for
+    int preparedSize = 0;
+
+    /// The cycle at its power of two length, its spectrum and the buffer each octave is transformed back in, the last two twice as long
+    juce::HeapBlock<float> source, spectrum, workspace;
+};
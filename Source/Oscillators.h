@@ -92,4 +92,112 @@ class SquareOsc : public Phasor
 
 private:
 	float pulseWidth = 0.5f;
-};
\ No newline at end of file
+};
+//=======================================
+
+//BLOCK RATE LFO class
+class BlockLfo
+{
+public:
+
+	// Fills a whole buffer of control samples at once rather than being called every sample:
+	// -- The shape is picked once per call, not once per sample, and there's no virtual call
+	// -- Each sample's phase is worked out from the start of the block, so the loops have no
+	//    dependency between samples and no branches, letting the compiler vectorise them
+	// -- The sine is a polynomial approximation rather than std::sin
+
+	// shapes in the same order as the lfo_shape parameter
+	enum Shape
+	{
+		sine = 0,
+		triangle,
+		saw,
+		square
+	};
+
+	void setSampleRate(float SR)
+	{
+		sampleRate = SR;
+		phaseDelta = frequency / sampleRate;
+	}
+
+	void setFrequency(float freq)
+	{
+		frequency = freq;
+		phaseDelta = frequency / sampleRate;
+	}
+
+	void setShape(int newShape)
+	{
+		shape = newShape;
+	}
+
+	void setPhase(float p)
+	{
+		phase = p;
+	}
+
+	// write the next numSamples samples of the lfo to dest
+	void process(float* dest, int numSamples)
+	{
+		const float startPhase = (float)phase;
+		const float delta = phaseDelta;
+
+		switch (shape)
+		{
+		case sine:
+			for (int i = 0; i < numSamples; i++)
+				dest[i] = sineShape(wrap(startPhase + (float)(i + 1) * delta));
+			break;
+		case triangle:
+			for (int i = 0; i < numSamples; i++)
+				dest[i] = triangleShape(wrap(startPhase + (float)(i + 1) * delta));
+			break;
+		case saw:
+			for (int i = 0; i < numSamples; i++)
+				dest[i] = wrap(startPhase + (float)(i + 1) * delta);
+			break;
+		case square:
+			for (int i = 0; i < numSamples; i++)
+				dest[i] = squareShape(wrap(startPhase + (float)(i + 1) * delta));
+			break;
+		}
+
+		// the phase is carried between blocks in double precision so it doesn't drift
+		phase += (double)numSamples * (double)phaseDelta;
+		phase -= std::floor(phase);
+	}
+
+private:
+	// keep only the fractional part of a positive phase
+	static inline float wrap(float p)
+	{
+		return p - (float)(int)p;
+	}
+
+	// sin(2 * pi * p) from a parabola with one correction step, error is around 0.001
+	static inline float sineShape(float p)
+	{
+		const float q = 2.0f * p - 1.0f;
+		const float y = -4.0f * q * (1.0f - fabsf(q));
+		return 0.225f * (y * fabsf(y) - y) + y;
+	}
+
+	static inline float triangleShape(float p)
+	{
+		return (fabsf(p - 0.5f) - 0.25f) * 4.0f;
+	}
+
+	static inline float squareShape(float p)
+	{
+		return p > pulseWidth ? -0.5f : 0.5f;
+	}
+
+	static constexpr float pulseWidth = 0.5f;
+
+	float frequency = 0.0f;
+	float sampleRate = 44100.0f;
+	double phase = 0.0;
+	float phaseDelta = 0.0f;
+	int shape = sine;
+};
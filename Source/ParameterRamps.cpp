@@ -0,0 +1,138 @@
+/*
+  ==============================================================================
+
+    ParameterRamps.cpp
+    Part of WavemorpherSynthesizer project
+
+    Created: 17th October 2026
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#include "ParameterRamps.h"
+
+void ParameterRamps::prepare(double sampleRate, int maximumBlockSize)
+{
+    rampBuffers.setSize(numPerSampleParameters, maximumBlockSize);
+    rampBuffers.clear();
+
+    // quick enough for the wavescan and mixer to follow a hand on a controller, the filter matches its own 50ms smoothing
+    auto lengthInSamples = [sampleRate](double seconds) { return juce::jmax(1, (int)std::floor(seconds * sampleRate)); };
+
+    for (int parameter = 0; parameter < numParameters; parameter++)
+    {
+        auto& ramp = ramps[parameter];
+        const bool isFilter = parameter == cutoff || parameter == resonance;
+
+        ramp.length = lengthInSamples(isFilter ? 0.05 : 0.02);
+        ramp.exponential = parameter == cutoff;
+        ramp.samplesLeft = 0;
+        ramp.blockRampSamples = 0;
+        ramp.jumpToTarget = true;
+        ramp.moving = false;
+    }
+}
+
+void ParameterRamps::setTarget(Parameter parameter, float newTarget) noexcept
+{
+    auto& ramp = ramps[parameter];
+
+    if (ramp.jumpToTarget)
+    {
+        ramp.current = ramp.target = newTarget;
+        ramp.samplesLeft = 0;
+        ramp.jumpToTarget = false;
+        return;
+    }
+
+    // like juce::SmoothedValue, only start a new ramp when the target actually changes
+    if (newTarget == ramp.target)
+        return;
+
+    ramp.target = newTarget;
+    ramp.samplesLeft = ramp.length;
+
+    // an exponential ramp can't cross or start from zero, so those fall back to linear
+    ramp.stepIsRatio = ramp.exponential && ramp.current > 0.0f && newTarget > 0.0f;
+
+    if (ramp.stepIsRatio)
+        ramp.step = std::exp(std::log(newTarget / ramp.current) / (float)ramp.length);
+    else
+        ramp.step = (newTarget - ramp.current) / (float)ramp.length;
+}
+
+void ParameterRamps::process(int numSamples) noexcept
+{
+    jassert(numSamples <= rampBuffers.getNumSamples());
+    numSamples = juce::jmin(numSamples, rampBuffers.getNumSamples());
+
+    for (int parameter = 0; parameter < numParameters; parameter++)
+    {
+        auto& ramp = ramps[parameter];
+
+        // a parameter sitting at its target costs nothing, the voices use its value as is
+        ramp.moving = ramp.samplesLeft > 0;
+
+        if (!ramp.moving)
+            continue;
+
+        const int rampSamples = juce::jmin(ramp.samplesLeft, numSamples);
+        ramp.blockStart = ramp.current;
+        ramp.blockRampSamples = rampSamples;
+        ramp.samplesLeft -= rampSamples;
+
+        // parameters only read at control points are just moved on, getValueAt works out the samples that are read
+        if (parameter >= numPerSampleParameters)
+        {
+            ramp.current = ramp.samplesLeft == 0 ? ramp.target
+                         : ramp.stepIsRatio ? ramp.current * std::pow(ramp.step, (float)rampSamples)
+                                            : ramp.current + (float)rampSamples * ramp.step;
+            continue;
+        }
+
+        auto* dest = rampBuffers.getWritePointer(parameter);
+        ramp.current = fillLinearRamp(dest, rampSamples, ramp.current, ramp.step);
+
+        // land exactly on the target, and hold it for the rest of the block
+        if (ramp.samplesLeft == 0)
+        {
+            ramp.current = ramp.target;
+
+            if (rampSamples > 0)
+                dest[rampSamples - 1] = ramp.target;
+
+            juce::FloatVectorOperations::fill(dest + rampSamples, ramp.target, numSamples - rampSamples);
+        }
+    }
+}
+
+const float* ParameterRamps::getRamp(Parameter parameter) const noexcept
+{
+    jassert(parameter < numPerSampleParameters);
+    return parameter < numPerSampleParameters && ramps[parameter].moving ? rampBuffers.getReadPointer(parameter) : nullptr;
+}
+
+float ParameterRamps::getValueAt(Parameter parameter, int sample) const noexcept
+{
+    const auto& ramp = ramps[parameter];
+
+    // steady, or past the end of the ramp, where it holds the value it reached
+    if (!ramp.moving || sample >= ramp.blockRampSamples - 1)
+        return ramp.current;
+
+    if (parameter < numPerSampleParameters)
+        return rampBuffers.getSample(parameter, sample);
+
+    return ramp.stepIsRatio ? ramp.blockStart * std::pow(ramp.step, (float)(sample + 1))
+                            : ramp.blockStart + (float)(sample + 1) * ramp.step;
+}
+
+float ParameterRamps::fillLinearRamp(float* dest, int numSamples, float start, float step) noexcept
+{
+    // every sample is worked out from the start, so the loop has no dependencies
+    for (int i = 0; i < numSamples; i++)
+        dest[i] = start + (float)(i + 1) * step;
+
+    return start + (float)numSamples * step;
+}
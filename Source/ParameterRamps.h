@@ -0,0 +1,140 @@
+/*
+  ==============================================================================
+
+    ParameterRamps.h
+    Part of WavemorpherSynthesizer project
+
+    Created: 17th October 2026
+    Author:  agent
+
+    Description: Smoothing for the parameters the voices read at audio rate,
+    so automating them doesn't zipper. Once per block each parameter that is
+    moving towards a new value and is read every sample has its ramp written
+    out as a contiguous buffer of per sample values, shared by every voice,
+    filled straight from its start and step so the loop vectorises. The
+    cutoff and resonance are only read by the filters at their control
+    points, so no buffer is written for them and just the values at those
+    points are worked out, the cutoff's on an exponential curve. A parameter
+    that isn't moving has no ramp at all and the voices carry on using its
+    value as a constant.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/*!
+ @class ParameterRamps
+ @abstract per sample smoothing of the wavescan, mixer and filter parameters, worked out for all the voices at once
+ @discussion like juce::SmoothedValue, a new target starts a fresh ramp that lands exactly on it after the ramp time
+
+ @namespace none
+ */
+class ParameterRamps
+{
+public:
+    /// Parameters that are smoothed, those read every sample first
+    enum Parameter
+    {
+        wavescan = 0,       ///< linear, over 20ms
+        wavetableVolume,    ///< linear, over 20ms
+        sineVolume,         ///< linear, over 20ms
+        cutoff,             ///< exponential so the sweep sounds even, over 50ms, read at control points
+        resonance,          ///< linear, over 50ms, read at control points
+        numParameters,
+        numPerSampleParameters = cutoff
+    };
+
+    //--------------------------------------------------------------------------
+    /**
+     Allocate the ramp buffers, not to be called from the audio thread
+
+     The first target given to each parameter afterwards is jumped to rather than ramped
+
+     @param sample rate
+     @param maximum number of samples in a block
+     */
+    void prepare(double sampleRate, int maximumBlockSize);
+
+    //--------------------------------------------------------------------------
+    /**
+     Set the value a parameter should ramp to, starting from the next block
+
+     @param parameter to set
+     @param new value
+     */
+    void setTarget(Parameter parameter, float newTarget) noexcept;
+
+    //--------------------------------------------------------------------------
+    /**
+     Move every parameter on by a block, writing the ramps of those read every sample that are moving
+
+     @param number of samples in the block
+     */
+    void process(int numSamples) noexcept;
+
+    //--------------------------------------------------------------------------
+    /**
+     Get the per sample values of a parameter read every sample for the block just processed
+
+     @param parameter to get, one before numPerSampleParameters
+     @return the block's samples, or null if the parameter sits at its target for the whole block
+     */
+    const float* getRamp(Parameter parameter) const noexcept;
+
+    //--------------------------------------------------------------------------
+    /**
+     Get the value of a parameter at one sample of the block just processed, without needing its ramp
+
+     @param parameter to get
+     @param sample of the block
+     @return where the parameter's smoothing had got to by the sample
+     */
+    float getValueAt(Parameter parameter, int sample) const noexcept;
+
+private:
+    //--------------------------------------------------------------------------
+    /// State of one parameter's smoothing
+    struct Ramp
+    {
+        /// Value at the end of the last block and the value being ramped to
+        float current = 0.0f, target = 0.0f;
+
+        /// Value at the start of the last block, and how many of its samples were ramped before the target was reached
+        float blockStart = 0.0f;
+        int blockRampSamples = 0;
+
+        /// Per sample step of a linear ramp, or per sample ratio of an exponential one
+        float step = 0.0f;
+
+        /// Samples left until the ramp reaches its target
+        int samplesLeft = 0;
+
+        /// Length of the ramp in samples
+        int length = 1;
+
+        /// Is the parameter smoothed exponentially rather than linearly
+        bool exponential = false;
+
+        /// Is the current ramp's step a ratio, false when an exponential ramp has had to fall back to linear
+        bool stepIsRatio = false;
+
+        /// Jump to the next target, set until the first target after preparing
+        bool jumpToTarget = true;
+
+        /// Was the parameter moving during the last block
+        bool moving = false;
+    };
+
+    /// Fill dest with a linear ramp that carries on from start, returning where the ramp ends
+    static float fillLinearRamp(float* dest, int numSamples, float start, float step) noexcept;
+
+    //--------------------------------------------------------------------------
+    /// Smoothing state of each parameter
+    Ramp ramps[numParameters];
+
+    /// One channel of per sample values for each parameter read every sample
+    juce::AudioBuffer<float> rampBuffers;
+};
@@ -17,16 +17,11 @@ WavemorpherSynthesizerAudioProcessorEditor::WavemorpherSynthesizerAudioProcessor
     //=========================================================================
     // TOP SECTION - WAVESCANNING
 
+    // the factory wavetables from binary data, followed by any in the wavetable library and any imported
+    refreshWavetableDropDowns();
+
     for (int slot = 0; slot < 5; slot++)
     {
-        for (int i = 0; i < BinaryData::namedResourceListSize; i++)
-        {
-            
-            // add all items from binary data to the current drop down slot
-            wavetableDropDowns[slot].addItem(BinaryData::originalFilenames[i], i + 1);
- 
-        }       
-        
         // add the drop downs and labels to the GUI
         addAndMakeVisible(wavetableDropDowns[slot]);
         addAndMakeVisible(dropDownLabels[slot]);
@@ -44,23 +39,38 @@ WavemorpherSynthesizerAudioProcessorEditor::WavemorpherSynthesizerAudioProcessor
     wavescanningSlider.setTextBoxStyle(juce::Slider::TextEntryBoxPosition::NoTextBox, true, 0, 0);
 
 
-    // adding listeners to every drop down menu and connecting them to the processor
+    // adding listeners to every drop down menu and connecting them to the processor, by item id rather than
+    // position, as the parameters leave room for a full library and the drop downs only list the tables there are
     wavetableDropDowns[0].addListener(this);
-    waveslotOneTree = new juce::AudioProcessorValueTreeState::ComboBoxAttachment(audioProcessor.parameters, "wavetype_one", wavetableDropDowns[0]);
+    waveslotOneTree = attachWavetableDropDown("wavetype_one", 0);
+    userTableTrees[0] = attachWavetableDropDown("usertable_one", 0);
     wavetableDropDowns[1].addListener(this);
-    waveslotTwoTree = new juce::AudioProcessorValueTreeState::ComboBoxAttachment(audioProcessor.parameters, "wavetype_two", wavetableDropDowns[1]);
+    waveslotTwoTree = attachWavetableDropDown("wavetype_two", 1);
+    userTableTrees[1] = attachWavetableDropDown("usertable_two", 1);
     wavetableDropDowns[2].addListener(this);
-    waveslotThreeTree = new juce::AudioProcessorValueTreeState::ComboBoxAttachment(audioProcessor.parameters, "wavetype_three", wavetableDropDowns[2]);
+    waveslotThreeTree = attachWavetableDropDown("wavetype_three", 2);
+    userTableTrees[2] = attachWavetableDropDown("usertable_three", 2);
     wavetableDropDowns[3].addListener(this);
-    waveslotFourTree = new juce::AudioProcessorValueTreeState::ComboBoxAttachment(audioProcessor.parameters, "wavetype_four", wavetableDropDowns[3]);
+    waveslotFourTree = attachWavetableDropDown("wavetype_four", 3);
+    userTableTrees[3] = attachWavetableDropDown("usertable_four", 3);
     wavetableDropDowns[4].addListener(this);
-    waveslotFiveTree = new juce::AudioProcessorValueTreeState::ComboBoxAttachment(audioProcessor.parameters, "wavetype_five", wavetableDropDowns[4]);
+    waveslotFiveTree = attachWavetableDropDown("wavetype_five", 4);
+    userTableTrees[4] = attachWavetableDropDown("usertable_five", 4);
 
 
     // add a listener to the slider and connect to the processor
     wavescanningSlider.addListener(this);
     wavescanTree = new juce::AudioProcessorValueTreeState::SliderAttachment(audioProcessor.parameters, "wavescan", wavescanningSlider);
 
+    // add the import button, progress bar and status, the import itself runs on the importer's threads
+    addAndMakeVisible(importButton);
+    importButton.addListener(this);
+    addAndMakeVisible(importProgressBar);
+    addAndMakeVisible(importStatusLabel);
+    importStatusLabel.setFont(labelFont);
+    importStatusLabel.setMinimumHorizontalScale(0.5f);
+    startTimerHz(10);
+
     //=========================================================================
     // MIXER
 
@@ -383,6 +393,12 @@ WavemorpherSynthesizerAudioProcessorEditor::WavemorpherSynthesizerAudioProcessor
     lfoSelection.addItem("Square", 4);
     lfoSelection.setSelectedId(1);
 
+    // add drop down box for choosing between one global lfo or one per voice
+    addAndMakeVisible(lfoModeSelection);
+    lfoModeSelection.addItem("Global", 1);
+    lfoModeSelection.addItem("Per Voice", 2);
+    lfoModeSelection.setSelectedId(1);
+
     // add 1st slider for lfo frequency, set range and appearance
     addAndMakeVisible(lfoFreqSlider);
     lfoFreqSlider.setRange(0, 10);
@@ -398,6 +414,8 @@ WavemorpherSynthesizerAudioProcessorEditor::WavemorpherSynthesizerAudioProcessor
     // adding listeners to every slider and connecting them to the processor
     lfoSelection.addListener(this);
     lfoSelectionTree = new juce::AudioProcessorValueTreeState::ComboBoxAttachment(audioProcessor.parameters, "lfo_shape", lfoSelection);
+    lfoModeSelection.addListener(this);
+    lfoModeTree = new juce::AudioProcessorValueTreeState::ComboBoxAttachment(audioProcessor.parameters, "lfo_mode", lfoModeSelection);
     lfoFreqSlider.addListener(this);
     lfoFreqTree = new juce::AudioProcessorValueTreeState::SliderAttachment(audioProcessor.parameters, "lfo_freq", lfoFreqSlider);
     lfoAmpSlider.addListener(this);
@@ -526,6 +544,11 @@ void WavemorpherSynthesizerAudioProcessorEditor::resized()
     // positioning the wavescan slider
     wavescanningSlider.setBounds(53, 165, 517, 20);
 
+    // positioning the import controls between the lines from the drop downs
+    importButton.setBounds(67, 130, 112, 20);
+    importProgressBar.setBounds(191, 130, 112, 20);
+    importStatusLabel.setBounds(315, 130, 117, 20);
+
     //=========================================================================
 
     mixerLabel.setBounds(622, 10, 102, 20);
@@ -601,6 +624,7 @@ void WavemorpherSynthesizerAudioProcessorEditor::resized()
 
     lfoLabel.setBounds(592, 204, 132, 20);
 
+    lfoModeSelection.setBounds(608, 229, 100, 20);
     lfoSelection.setBounds(608, 259, 100, 20);
     lfoSelectionLabel.setBounds(608, 294, 100, 15);
    
@@ -622,8 +646,100 @@ void WavemorpherSynthesizerAudioProcessorEditor::sliderValueChanged(juce::Slider
 
 void WavemorpherSynthesizerAudioProcessorEditor::comboBoxChanged(juce::ComboBox* comboBox)
 {
- 
-    
+    juce::ParameterAttachment* waveslotTrees[5] = { waveslotOneTree, waveslotTwoTree, waveslotThreeTree, waveslotFourTree, waveslotFiveTree };
+
+    // a factory table picked from a slot's drop down sets its wavetype and clears its user table, any other sets its user table
+    for (int slot = 0; slot < 5; slot++)
+    {
+        if (comboBox != &wavetableDropDowns[slot] || waveslotTrees[slot] == nullptr || userTableTrees[slot] == nullptr || comboBox->getSelectedId() <= 0)
+            continue;
+
+        const int index = comboBox->getSelectedId() - 1;
+        const int userTable = WavetableBank::getUserTable(index);
+
+        if (userTable == 0)
+            waveslotTrees[slot]->setValueAsCompleteGesture((float)index);
+
+        userTableTrees[slot]->setValueAsCompleteGesture((float)userTable);
+    }
 }
 
+void WavemorpherSynthesizerAudioProcessorEditor::refreshWavetableDropDowns()
+{
+    const juce::StringArray wavetableNames = audioProcessor.getWavetableNames();
+
+    numWavetableImportsListed = audioProcessor.getNumWavetableImports();
+
+    for (int slot = 0; slot < 5; slot++)
+    {
+        wavetableDropDowns[slot].clear(juce::dontSendNotification);
 
+        // add all the wavetables there are to the current drop down slot, the id is always the wavetable index plus one
+        for (int i = 0; i < wavetableNames.size(); i++)
+            if (wavetableNames[i].isNotEmpty())
+                wavetableDropDowns[slot].addItem(wavetableNames[i], i + 1);
+
+        // and select the one the slot is set to again
+        showSlotWavetable(slot);
+    }
+}
+
+juce::ParameterAttachment* WavemorpherSynthesizerAudioProcessorEditor::attachWavetableDropDown(const juce::String& parameterID, int slot)
+{
+    // the selection depends on both of the slot's parameters, so it is worked out from their current values whichever changed
+    auto* attachment = new juce::ParameterAttachment(*audioProcessor.parameters.getParameter(parameterID), [this, slot](float)
+    {
+        showSlotWavetable(slot);
+    });
+
+    attachment->sendInitialUpdate();
+    return attachment;
+}
+
+void WavemorpherSynthesizerAudioProcessorEditor::showSlotWavetable(int slot)
+{
+    const char* wavetypeIDs[5] = { "wavetype_one", "wavetype_two", "wavetype_three", "wavetype_four", "wavetype_five" };
+    const char* userTableIDs[5] = { "usertable_one", "usertable_two", "usertable_three", "usertable_four", "usertable_five" };
+
+    const int factoryTable = juce::roundToInt(audioProcessor.parameters.getRawParameterValue(wavetypeIDs[slot])->load());
+    const int userTable = juce::roundToInt(audioProcessor.parameters.getRawParameterValue(userTableIDs[slot])->load());
+
+    // a table that isn't there selects nothing
+    wavetableDropDowns[slot].setSelectedId(WavetableBank::getWavetableIndex(factoryTable, userTable) + 1, juce::dontSendNotification);
+}
+
+void WavemorpherSynthesizerAudioProcessorEditor::buttonClicked(juce::Button* button)
+{
+    if (button != &importButton)
+        return;
+
+    // one cycle per file, or a Serum style file of several frames
+    importChooser = std::make_unique<juce::FileChooser>("Import wavetables", juce::File(), WavetableImporter::fileWildcard);
+
+    const int flags = juce::FileBrowserComponent::openMode
+                    | juce::FileBrowserComponent::canSelectFiles
+                    | juce::FileBrowserComponent::canSelectMultipleItems;
+
+    importChooser->launchAsync(flags, [this](const juce::FileChooser& chooser)
+    {
+        if (chooser.getResults().isEmpty())
+            return;
+
+        audioProcessor.getWavetableImporter().importFiles(chooser.getResults());
+        timerCallback();
+    });
+}
+
+void WavemorpherSynthesizerAudioProcessorEditor::timerCallback()
+{
+    auto& importer = audioProcessor.getWavetableImporter();
+    const bool importing = importer.isImporting();
+
+    importProgress = importing ? importer.getProgress() : 0.0;
+    importButton.setEnabled(!importing);
+    importStatusLabel.setText(importer.getStatus(), juce::dontSendNotification);
+
+    // a finished import has changed the names of the imported wavetables
+    if (audioProcessor.getNumWavetableImports() != numWavetableImportsListed)
+        refreshWavetableDropDowns();
+}
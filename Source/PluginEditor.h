@@ -17,7 +17,9 @@
 */
 class WavemorpherSynthesizerAudioProcessorEditor  : public juce::AudioProcessorEditor,
     public juce::Slider::Listener,
-    public juce::ComboBox::Listener
+    public juce::ComboBox::Listener,
+    public juce::Button::Listener,
+    private juce::Timer
 {
 public:
     WavemorpherSynthesizerAudioProcessorEditor (WavemorpherSynthesizerAudioProcessor&);
@@ -31,6 +33,8 @@ public:
 
     void comboBoxChanged(juce::ComboBox* comboBox) override;
 
+    void buttonClicked(juce::Button* button) override;
+
 
 private:
     
@@ -43,21 +47,42 @@ private:
     
     juce::ComboBox* wavetableDropDowns = new juce::ComboBox[5];
 
-    juce::ScopedPointer<juce::AudioProcessorValueTreeState::ComboBoxAttachment> waveslotOneTree;
+    juce::ScopedPointer<juce::ParameterAttachment> waveslotOneTree;
     juce::Label dropDownLabelOne{ {}, "Slot One" };
-    juce::ScopedPointer<juce::AudioProcessorValueTreeState::ComboBoxAttachment> waveslotTwoTree;
+    juce::ScopedPointer<juce::ParameterAttachment> waveslotTwoTree;
     juce::Label dropDownLabelTwo{ {}, "Slot Two" };
-    juce::ScopedPointer<juce::AudioProcessorValueTreeState::ComboBoxAttachment> waveslotThreeTree;
+    juce::ScopedPointer<juce::ParameterAttachment> waveslotThreeTree;
     juce::Label dropDownLabelThree{ {}, "Slot Three" };
-    juce::ScopedPointer<juce::AudioProcessorValueTreeState::ComboBoxAttachment> waveslotFourTree;
+    juce::ScopedPointer<juce::ParameterAttachment> waveslotFourTree;
     juce::Label dropDownLabelFour{ {}, "Slot Four" };
-    juce::ScopedPointer<juce::AudioProcessorValueTreeState::ComboBoxAttachment> waveslotFiveTree;
+    juce::ScopedPointer<juce::ParameterAttachment> waveslotFiveTree;
     juce::Label dropDownLabelFive{ {}, "Slot Five" };
     juce::Label* dropDownLabels[5] = { &dropDownLabelOne, &dropDownLabelTwo, &dropDownLabelThree, &dropDownLabelFour, &dropDownLabelFive };
 
+    // each slot's user table parameter, which picks a library or imported table over the factory one its wavetype picks
+    juce::ScopedPointer<juce::ParameterAttachment> userTableTrees[5];
+
     juce::Slider wavescanningSlider;
     juce::ScopedPointer<juce::AudioProcessorValueTreeState::SliderAttachment> wavescanTree;
 
+    // connect a slot's drop down to its wavetype or user table parameter, either changing updates the selected item
+    juce::ParameterAttachment* attachWavetableDropDown(const juce::String& parameterID, int slot);
+
+    // select the item of the wavetable a slot plays, whose id is always its wavetable index plus one
+    void showSlotWavetable(int slot);
+
+    // fill every slot's drop down with the wavetables there are, again whenever an import changes them
+    void refreshWavetableDropDowns();
+    juce::uint32 numWavetableImportsListed = 0;
+
+    // importing wavetables from disk, the progress and status are polled from the importer by the timer
+    juce::TextButton importButton{ "Import..." };
+    double importProgress = 0.0;
+    juce::ProgressBar importProgressBar{ importProgress };
+    juce::Label importStatusLabel;
+    std::unique_ptr<juce::FileChooser> importChooser;
+
+    void timerCallback() override;
     
     //=================================================================================
     // MIXER SECTION
@@ -179,6 +204,9 @@ private:
     juce::Label lfoSelectionLabel{ {}, "Shape" };
     juce::ScopedPointer<juce::AudioProcessorValueTreeState::ComboBoxAttachment> lfoSelectionTree;
 
+    juce::ComboBox lfoModeSelection;
+    juce::ScopedPointer<juce::AudioProcessorValueTreeState::ComboBoxAttachment> lfoModeTree;
+
     juce::Slider lfoFreqSlider;
     juce::Label lfoFreqLabel{ {}, "Frequency" };
     juce::ScopedPointer<juce::AudioProcessorValueTreeState::SliderAttachment> lfoFreqTree;
@@ -22,17 +22,10 @@ WavemorpherSynthesizerAudioProcessor::WavemorpherSynthesizerAudioProcessor()
                        ),
     
 #endif
-    slotOneIndexGUI(0),
-    slotTwoIndexGUI(2),
-    slotThreeIndexGUI(4),
-    slotFourIndexGUI(6),
-    slotFiveIndexGUI(8),
-    slotOneIndexCurrent(0),
-    slotTwoIndexCurrent(2),
-    slotThreeIndexCurrent(4),
-    slotFourIndexCurrent(6),
-    slotFiveIndexCurrent(8),
-    parameters(*this, nullptr)
+    parameters(*this, nullptr),
+    wavetableLibrary(WavetableLibrary::open(WavetableLibrary::getDefaultFile())),
+    wavetableBuilder(parameters, wavetableLibrary),
+    wavetableImporter(wavetableBuilder)
 
 {
     //==========================================================================
@@ -41,8 +34,8 @@ WavemorpherSynthesizerAudioProcessor::WavemorpherSynthesizerAudioProcessor()
     parameters.createAndAddParameter("wavescan", "Wavescan", "Wavescan", wavescanRange, 2.0f, nullptr, nullptr);
     
     //==========================================================================
-    // add wavetable type selection parameter to ValueTreeState
-    juce::NormalisableRange<float> wavetableTypeRange(0, 19);
+    // add wavetable type selection parameter to ValueTreeState, covering only the factory tables so saved automation keeps its meaning
+    juce::NormalisableRange<float> wavetableTypeRange(0.0f, (float)(BinaryData::namedResourceListSize - 1), 1.0f);
     parameters.createAndAddParameter("wavetype_one", "Wave Type One", "Wavetable One", wavetableTypeRange, 0, nullptr, nullptr);
 
     parameters.createAndAddParameter("wavetype_two", "Wave Type Two", "Wavetable Two", wavetableTypeRange, 2, nullptr, nullptr);
@@ -53,6 +46,19 @@ WavemorpherSynthesizerAudioProcessor::WavemorpherSynthesizerAudioProcessor()
 
     parameters.createAndAddParameter("wavetype_five", "Wave Type Five", "Wavetable Five", wavetableTypeRange, 8, nullptr, nullptr);
 
+    // add user table selection parameters, 0 - the factory table the wavetype picks, then the library tables and the imported ones,
+    // with room for a full library so the same value always picks the same table however many the library holds
+    juce::NormalisableRange<float> userTableRange(0.0f, (float)WavetableBank::getNumUserTables(), 1.0f);
+    parameters.createAndAddParameter("usertable_one", "User Table One", "User Table One", userTableRange, 0, nullptr, nullptr);
+
+    parameters.createAndAddParameter("usertable_two", "User Table Two", "User Table Two", userTableRange, 0, nullptr, nullptr);
+
+    parameters.createAndAddParameter("usertable_three", "User Table Three", "User Table Three", userTableRange, 0, nullptr, nullptr);
+
+    parameters.createAndAddParameter("usertable_four", "User Table Four", "User Table Four", userTableRange, 0, nullptr, nullptr);
+
+    parameters.createAndAddParameter("usertable_five", "User Table Five", "User Table Five", userTableRange, 0, nullptr, nullptr);
+
     //==========================================================================
     // add mixer parameters to value tree state
     juce::NormalisableRange<float> mixerRange(0, 2);
@@ -61,6 +67,10 @@ WavemorpherSynthesizerAudioProcessor::WavemorpherSynthesizerAudioProcessor()
 
     parameters.createAndAddParameter("sine_synth", "Sine Synth", "Sine Synth", mixerRange, 1.0f, nullptr, nullptr);
 
+    // 0 - every voice in the centre, 1 - voices spread evenly from hard left to hard right
+    juce::NormalisableRange<float> stereoSpreadRange(0.0f, 1.0f);
+    parameters.createAndAddParameter("stereo_spread", "Stereo Spread", "Stereo Spread", stereoSpreadRange, 0.0f, nullptr, nullptr);
+
     //==========================================================================
     // add ADSR parameters to value tree state
     juce::NormalisableRange<float> attackRange(0.0f, 1.0f);
@@ -101,6 +111,10 @@ WavemorpherSynthesizerAudioProcessor::WavemorpherSynthesizerAudioProcessor()
     juce::NormalisableRange<float> filterResonanceAmpRange(-1.0f, 1.0f);
     parameters.createAndAddParameter("filter_resonance_amp", "Filter Resonance Env Amp", "Filter Resonance Env Amp", filterResonanceAmpRange, 0.0f, nullptr, nullptr);
 
+    // how often the filter envelope updates the filters, 0 - every 16 samples, 1 - every 32, 2 - every 64
+    juce::NormalisableRange<float> controlRateRange(0, 2);
+    parameters.createAndAddParameter("control_rate", "Control Rate", "Control Rate", controlRateRange, 1, nullptr, nullptr);
+
     //==========================================================================
     juce::NormalisableRange<float> chorusDepthRange(0.0f, 1.0f);
     parameters.createAndAddParameter("chorus_depth", "Chorus Depth", "Chorus Depth", chorusDepthRange, 0.1f, nullptr, nullptr);
@@ -108,6 +122,12 @@ WavemorpherSynthesizerAudioProcessor::WavemorpherSynthesizerAudioProcessor()
     juce::NormalisableRange<float> chorusMixRange(0.0f, 1.0f);
     parameters.createAndAddParameter("chorus_mix", "Chorus Mix", "Chorus Mix", chorusMixRange, 0.1f, nullptr, nullptr);
 
+    // 0 - chorus and reverb run inline, 1 - on their own thread with one block of latency,
+    // not automatable as it changes the latency, it takes effect when the host next prepares the plugin
+    juce::NormalisableRange<float> pipelinedEffectsRange(0, 1);
+    parameters.createAndAddParameter("pipelined_effects", "Pipelined Effects", "Pipelined Effects", pipelinedEffectsRange, 0, nullptr, nullptr,
+                                     false, false, true, juce::AudioProcessorParameter::genericParameter, true);
+
     //==========================================================================
     juce::NormalisableRange<float> roomSizeRange(0.0f, 1.0f);
     parameters.createAndAddParameter("room_size", "Room Size", "Room Size", roomSizeRange, 0.5f, nullptr, nullptr);
@@ -131,21 +151,48 @@ WavemorpherSynthesizerAudioProcessor::WavemorpherSynthesizerAudioProcessor()
     juce::NormalisableRange<float> lfoAmpRange(0.0f, 4.0f);
     parameters.createAndAddParameter("lfo_amp", "LFO Amp", "LFO Amp", lfoAmpRange, 0.0f, nullptr, nullptr);
 
+    // 0 - one global lfo shared by every voice, 1 - an lfo per voice retriggered on every note
+    juce::NormalisableRange<float> lfoModeRange(0, 1);
+    parameters.createAndAddParameter("lfo_mode", "LFO Mode", "LFO Mode", lfoModeRange, 0, nullptr, nullptr);
+
+    //==========================================================================
+    // number of voices that can play at once, up to all the voices added to the synthesiser
+    juce::NormalisableRange<float> polyphonyRange(1.0f, (float)WavetableSynthesiser::maxVoices, 1.0f);
+    parameters.createAndAddParameter("polyphony", "Polyphony", "Polyphony", polyphonyRange, 10.0f, nullptr, nullptr);
+
+    // 0 - oldest released voice first, 1 - oldest voice, 2 - quietest voice, 3 - no stealing
+    juce::NormalisableRange<float> voiceStealingRange(0, 3);
+    parameters.createAndAddParameter("voice_stealing", "Voice Stealing", "Voice Stealing", voiceStealingRange, 0, nullptr, nullptr);
+
+    // 0 - voices rendered on the audio thread, 1 - voices spread across worker threads when enough are playing
+    juce::NormalisableRange<float> multiCoreRange(0, 1);
+    parameters.createAndAddParameter("multicore", "Multi-core Rendering", "Multi-core Rendering", multiCoreRange, 0, nullptr, nullptr);
+
+    // grid midi events other than note ons are moved onto, 0 - sample accurate, 1 - 8 samples, 2 - 16 samples, 3 - 32 samples
+    juce::NormalisableRange<float> eventGridRange(0, 3);
+    parameters.createAndAddParameter("event_grid", "MIDI Event Grid", "MIDI Event Grid", eventGridRange, 2, nullptr, nullptr);
+
     parameters.state = juce::ValueTree("Foo");
 
+    cacheParameterHandles();
+
     //==========================================================================
-    // add wavetable synth voices to the synthesiser class
-    for (int i = 0; i < voiceCount; i++)
+    // add wavetable synth voices to the synthesiser class, all of them up front as idle voices cost nothing
+    for (int i = 0; i < WavetableSynthesiser::maxVoices; i++)
     {
         synth.addVoice(new WavetableSynthVoice());
     }
 
     // add wavetable synth sound to the synthesiser class
     synth.addSound(new WavetableSynthSound());
+
+    // watch for the pipelined effects setting changing, to tell the host the latency it will have
+    startTimer(250);
 }
 
 WavemorpherSynthesizerAudioProcessor::~WavemorpherSynthesizerAudioProcessor()
 {
+    stopTimer();
 }
 
 //==============================================================================
@@ -213,31 +260,34 @@ void WavemorpherSynthesizerAudioProcessor::changeProgramName (int index, const j
 //==============================================================================
 void WavemorpherSynthesizerAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
-    // Preparing the synthesizer by setting the sample rate
-    synth.setCurrentPlaybackSampleRate(sampleRate);
-
-    // Preparation for the chorus, giving it the sample rate, samples per block and number of channels
-    juce::dsp::ProcessSpec spec;
-    spec.maximumBlockSize = samplesPerBlock;
-    spec.sampleRate = sampleRate;
-    spec.numChannels = getNumOutputChannels();
-    chorus.prepare(spec);
-    chorus.reset();
-    
-    // Preparing the reverb with a reset
-    reverb.reset();;
+    // Preparing the synthesizer by setting the sample rate and setting up the voices' filter bank, it only ever renders a quantum at a time
+    synth.prepare(sampleRate, quantumSize);
+
+    // room for a busy quantum's worth of midi events, so splitting the host's midi up doesn't allocate
+    quantumMidi.ensureSize(2048);
+
+    // Preparing the chorus and reverb, and the thread they run on in pipelined mode
+    sendEffects.prepare(sampleRate, samplesPerBlock, getTotalNumOutputChannels(), *parameterHandles.pipelinedEffects >= 0.5f);
+    setLatencySamples(sendEffects.getLatencySamples());
+
+    // Preparing the global LFO and the buffer it fills once per quantum for all the voices
+    globalLfo.setSampleRate(sampleRate);
+    globalLfoChangeCount = ~0u;
+    globalLfoBuffer.setSize(1, quantumSize);
+
+    // Preparing the smoothing of the audio rate parameters, they start out at their current values
+    parameterRamps.prepare(sampleRate, quantumSize);
+
+    // decode and antialias the wavetables for the slots, only blocks here the first time
+    wavetableBuilder.prepare(sampleRate);
 
     // Setting up all the synthesizer voices
-    for (int i = 0; i < voiceCount; i++)
+    for (int i = 0; i < synth.getNumVoices(); i++)
     {
         WavetableSynthVoice* v = dynamic_cast<WavetableSynthVoice*>(synth.getVoice(i));
         
-        // give each wavetable slot in ititial index from the drop down menus
-        v->updateWavetable(int(slotOneIndexCurrent), 0);
-        v->updateWavetable(int(slotTwoIndexCurrent), 1);
-        v->updateWavetable(int(slotThreeIndexCurrent), 2);
-        v->updateWavetable(int(slotFourIndexCurrent), 3);
-        v->updateWavetable(int(slotFiveIndexCurrent), 4);
+        // give each voice the wavetables initially loaded into the slots
+        v->setWavescanTables(wavetableBuilder.getCurrentTables());
 
         // providing the voices with other essential information (SR, block size, channel number)
         v->prepareToPlay(sampleRate, samplesPerBlock, getTotalNumOutputChannels());
@@ -249,6 +299,7 @@ void WavemorpherSynthesizerAudioProcessor::releaseResources()
 {
     // When playback stops, you can use this as an opportunity to free up any
     // spare memory, etc.
+    sendEffects.release();
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -281,134 +332,186 @@ void WavemorpherSynthesizerAudioProcessor::processBlock (juce::AudioBuffer<float
 {
     juce::ScopedNoDenormals noDenormals;
 
+    // voice allocation settings, a lowered polyphony lets the voices above it fade out
+    synth.setPolyphony(int(*parameterHandles.polyphony));
+    synth.setStealingPolicy(WavetableSynthesiser::StealingPolicy(int(*parameterHandles.voiceStealing)));
+    synth.setMultiCoreRendering(*parameterHandles.multicore >= 0.5f);
 
+    // faster control rates follow the filter envelope more closely for a little more work per block
+    synth.setControlRate(16 << juce::jlimit(0, 2, int(*parameterHandles.controlRate)));
 
-    for (int i = 0; i < voiceCount; i++)
-    {
-        WavetableSynthVoice* v = dynamic_cast<WavetableSynthVoice*>(synth.getVoice(i));
-
-        v->setWavescanVal(parameters.getRawParameterValue("wavescan"));
-        
-        v->setWavetableVolume(parameters.getRawParameterValue("wave_synth"));
-        v->setSineVolume(parameters.getRawParameterValue("sine_synth"));
+    // a coarser grid renders dense controller streams in fewer, longer pieces
+    const int eventGridSetting = juce::jlimit(0, 3, int(*parameterHandles.eventGrid));
+    synth.setEventGrid(eventGridSetting == 0 ? 1 : 4 << eventGridSetting);
 
+    // pick up any wavetables the builder thread has published since the last block
+    WavescanTables* tables = wavetableBuilder.getCurrentTables();
+    MorphTable* morphTable = wavetableBuilder.getCurrentMorphTable();
 
-        v->updateADSR(parameters.getRawParameterValue("attack"), parameters.getRawParameterValue("decay"), parameters.getRawParameterValue("sustain"), parameters.getRawParameterValue("release"));
+    // the synthesiser works through the block a fixed quantum at a time, so its buffers are the same small size whatever the host's block size
+    for (int quantumStart = 0; quantumStart < buffer.getNumSamples(); quantumStart += quantumSize)
+    {
+        const int quantumLength = juce::jmin(quantumSize, buffer.getNumSamples() - quantumStart);
 
+        // this quantum of the host's buffer, and the midi events that fall in it moved to its start
+        juce::AudioBuffer<float> quantum(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), quantumStart, quantumLength);
 
-        v->updateFilter(*parameters.getRawParameterValue("cutoff"), *parameters.getRawParameterValue("resonance"));
-        v->updateFilterEnv(parameters.getRawParameterValue("filter_attack"), parameters.getRawParameterValue("filter_decay"), parameters.getRawParameterValue("filter_sustain"), parameters.getRawParameterValue("filter_release"));
-        v->updateFilterEnvAmp(parameters.getRawParameterValue("filter_cutoff_amp"), parameters.getRawParameterValue("filter_resonance_amp"));
+        quantumMidi.clear();
+        quantumMidi.addEvents(midiMessages, quantumStart, quantumLength, -quantumStart);
 
-        v->updateLfo(parameters.getRawParameterValue("lfo_freq"), parameters.getRawParameterValue("lfo_amp"), parameters.getRawParameterValue("lfo_shape"));
+        renderQuantum(quantum, quantumMidi, tables, morphTable);
     }
 
-    slotOneIndexGUI = *parameters.getRawParameterValue("wavetype_one");
-    slotTwoIndexGUI = *parameters.getRawParameterValue("wavetype_two");
-    slotThreeIndexGUI = *parameters.getRawParameterValue("wavetype_three");
-    slotFourIndexGUI = *parameters.getRawParameterValue("wavetype_four");
-    slotFiveIndexGUI = *parameters.getRawParameterValue("wavetype_five");
-    
-    // only call the set wavetable function if something has been changed in the indices
-    if (slotOneIndexGUI != slotOneIndexCurrent)
-    {
-        // update binary index parameter
-        slotOneIndexCurrent = slotOneIndexGUI;
+    SendEffects::Parameters effectsParameters;
 
-        for (int i = 0; i < voiceCount; i++)
-        {
-            WavetableSynthVoice* v = dynamic_cast<WavetableSynthVoice*>(synth.getVoice(i));
+    effectsParameters.chorusDepth = *parameterHandles.chorusDepth;
+    effectsParameters.chorusMix = *parameterHandles.chorusMix;
 
-            // now call the setWavetable function for each slot
-            // it will only actually do anything if new index =/= current index
-            v->updateWavetable(int(slotOneIndexCurrent), 0);
-        }
-    }
+    effectsParameters.reverb.roomSize = *parameterHandles.roomSize;
+    effectsParameters.reverb.damping = *parameterHandles.damping;
+    effectsParameters.reverb.dryLevel = *parameterHandles.dry;
+    effectsParameters.reverb.wetLevel = *parameterHandles.wet;
 
-    // do the same for the others
-    if (slotTwoIndexGUI != slotTwoIndexCurrent)
-    {
-        // update binary index parameter
-        slotTwoIndexCurrent = slotTwoIndexGUI;
-
-        for (int i = 0; i < voiceCount; i++)
-        {
-            WavetableSynthVoice* v = dynamic_cast<WavetableSynthVoice*>(synth.getVoice(i));
+    // in pipelined mode this hands the block to the effects thread and outputs the block before it, already processed
+    sendEffects.process(buffer, effectsParameters);
 
-            // now call the setWavetable function for each slot
-            // it will only actually do anything if new index =/= current index
-            v->updateWavetable(int(slotTwoIndexCurrent), 1);
-        }
-    }
+    // this block is done with the tables, let the builder know so old ones can be freed
+    wavetableBuilder.audioBlockFinished();
+}
 
-    if (slotThreeIndexGUI != slotThreeIndexCurrent)
-    {
-        // update binary index parameter
-        slotThreeIndexCurrent = slotThreeIndexGUI;
+void WavemorpherSynthesizerAudioProcessor::renderQuantum(juce::AudioBuffer<float>& quantum, const juce::MidiBuffer& midi, WavescanTables* tables, MorphTable* morphTable)
+{
+    const int numSamples = quantum.getNumSamples();
+    jassert(numSamples <= quantumSize);
 
-        for (int i = 0; i < voiceCount; i++)
-        {
-            WavetableSynthVoice* v = dynamic_cast<WavetableSynthVoice*>(synth.getVoice(i));
+    // read the parameters once for all the voices, the synthesiser hands them to the voices playing and to each voice as it starts
+    VoiceParameters voiceParameters = makeVoiceParameters();
 
-            // now call the setWavetable function for each slot
-            // it will only actually do anything if new index =/= current index
-            v->updateWavetable(int(slotThreeIndexCurrent), 2);
-        }
-    }
+    voiceParameters.tables = tables;
+    voiceParameters.morphTable = morphTable;
 
-    if (slotFourIndexGUI != slotFourIndexCurrent)
+    // in global mode the lfo is worked out once here, and every voice reads the same samples
+    if (*parameterHandles.lfoMode < 0.5f)
     {
-        // update binary index parameter
-        slotFourIndexCurrent = slotFourIndexGUI;
-
-        for (int i = 0; i < voiceCount; i++)
+        if (globalLfoChangeCount != voiceParameters.changeCounts[VoiceParameters::lfoGroup])
         {
-            WavetableSynthVoice* v = dynamic_cast<WavetableSynthVoice*>(synth.getVoice(i));
-
-            // now call the setWavetable function for each slot
-            // it will only actually do anything if new index =/= current index
-            v->updateWavetable(int(slotFourIndexCurrent), 3);
+            globalLfo.setShape(voiceParameters.lfoShape);
+            globalLfo.setFrequency(voiceParameters.lfoFreq);
+            globalLfoChangeCount = voiceParameters.changeCounts[VoiceParameters::lfoGroup];
         }
+
+        globalLfo.process(globalLfoBuffer.getWritePointer(0), numSamples);
+        voiceParameters.globalLfoSamples = globalLfoBuffer.getReadPointer(0);
     }
 
-    if (slotFiveIndexGUI != slotFiveIndexCurrent)
-    {
-        // update binary index parameter
-        slotFiveIndexCurrent = slotFiveIndexGUI;
+    // smooth the parameters the voices read, a ramp is only written for those read every sample that are moving
+    parameterRamps.setTarget(ParameterRamps::wavescan, voiceParameters.wavescan);
+    parameterRamps.setTarget(ParameterRamps::wavetableVolume, voiceParameters.wavetableVolume);
+    parameterRamps.setTarget(ParameterRamps::sineVolume, voiceParameters.sineVolume);
+    parameterRamps.setTarget(ParameterRamps::cutoff, voiceParameters.cutoff);
+    parameterRamps.setTarget(ParameterRamps::resonance, voiceParameters.resonance);
+    parameterRamps.process(numSamples);
 
-        for (int i = 0; i < voiceCount; i++)
-        {
-            WavetableSynthVoice* v = dynamic_cast<WavetableSynthVoice*>(synth.getVoice(i));
+    voiceParameters.wavescanRamp = parameterRamps.getRamp(ParameterRamps::wavescan);
+    voiceParameters.wavetableVolumeRamp = parameterRamps.getRamp(ParameterRamps::wavetableVolume);
+    voiceParameters.sineVolumeRamp = parameterRamps.getRamp(ParameterRamps::sineVolume);
+    voiceParameters.filterRamps = &parameterRamps;
 
-            // now call the setWavetable function for each slot
-            // it will only actually do anything if new index =/= current index
-            v->updateWavetable(int(slotFiveIndexCurrent), 4);
-        }
-    }
+    synth.setVoiceParameters(voiceParameters);
+    lastVoiceParameters = voiceParameters;
 
-    synth.renderNextBlock(buffer, midiMessages, 0, buffer.getNumSamples());
+    synth.renderBlock(quantum, midi, 0, numSamples);
+}
+
+//==============================================================================
+void WavemorpherSynthesizerAudioProcessor::cacheParameterHandles()
+{
+    parameterHandles.wavescan = parameters.getRawParameterValue("wavescan");
+    parameterHandles.waveSynth = parameters.getRawParameterValue("wave_synth");
+    parameterHandles.sineSynth = parameters.getRawParameterValue("sine_synth");
+    parameterHandles.stereoSpread = parameters.getRawParameterValue("stereo_spread");
+    parameterHandles.attack = parameters.getRawParameterValue("attack");
+    parameterHandles.decay = parameters.getRawParameterValue("decay");
+    parameterHandles.sustain = parameters.getRawParameterValue("sustain");
+    parameterHandles.release = parameters.getRawParameterValue("release");
+    parameterHandles.cutoff = parameters.getRawParameterValue("cutoff");
+    parameterHandles.resonance = parameters.getRawParameterValue("resonance");
+    parameterHandles.filterAttack = parameters.getRawParameterValue("filter_attack");
+    parameterHandles.filterDecay = parameters.getRawParameterValue("filter_decay");
+    parameterHandles.filterSustain = parameters.getRawParameterValue("filter_sustain");
+    parameterHandles.filterRelease = parameters.getRawParameterValue("filter_release");
+    parameterHandles.filterCutoffAmp = parameters.getRawParameterValue("filter_cutoff_amp");
+    parameterHandles.filterResonanceAmp = parameters.getRawParameterValue("filter_resonance_amp");
+    parameterHandles.controlRate = parameters.getRawParameterValue("control_rate");
+    parameterHandles.chorusDepth = parameters.getRawParameterValue("chorus_depth");
+    parameterHandles.chorusMix = parameters.getRawParameterValue("chorus_mix");
+    parameterHandles.pipelinedEffects = parameters.getRawParameterValue("pipelined_effects");
+    parameterHandles.roomSize = parameters.getRawParameterValue("room_size");
+    parameterHandles.damping = parameters.getRawParameterValue("damping");
+    parameterHandles.dry = parameters.getRawParameterValue("dry");
+    parameterHandles.wet = parameters.getRawParameterValue("wet");
+    parameterHandles.lfoShape = parameters.getRawParameterValue("lfo_shape");
+    parameterHandles.lfoFreq = parameters.getRawParameterValue("lfo_freq");
+    parameterHandles.lfoAmp = parameters.getRawParameterValue("lfo_amp");
+    parameterHandles.lfoMode = parameters.getRawParameterValue("lfo_mode");
+    parameterHandles.polyphony = parameters.getRawParameterValue("polyphony");
+    parameterHandles.voiceStealing = parameters.getRawParameterValue("voice_stealing");
+    parameterHandles.multicore = parameters.getRawParameterValue("multicore");
+    parameterHandles.eventGrid = parameters.getRawParameterValue("event_grid");
+}
 
+VoiceParameters WavemorpherSynthesizerAudioProcessor::makeVoiceParameters()
+{
+    VoiceParameters voiceParameters;
 
-    chorus.setDepth(*parameters.getRawParameterValue("chorus_depth"));
-    chorus.setMix(*parameters.getRawParameterValue("chorus_mix"));
+    voiceParameters.wavescan = *parameterHandles.wavescan;
 
+    voiceParameters.wavetableVolume = *parameterHandles.waveSynth;
+    voiceParameters.sineVolume = *parameterHandles.sineSynth;
+    voiceParameters.stereoSpread = *parameterHandles.stereoSpread;
 
+    voiceParameters.envelope.attack = *parameterHandles.attack;
+    voiceParameters.envelope.decay = *parameterHandles.decay;
+    voiceParameters.envelope.sustain = *parameterHandles.sustain;
+    voiceParameters.envelope.release = *parameterHandles.release;
 
-    juce::dsp::AudioBlock<float> sampleBlock(buffer);
-    chorus.process(juce::dsp::ProcessContextReplacing<float>(sampleBlock));
+    voiceParameters.cutoff = *parameterHandles.cutoff;
+    voiceParameters.resonance = *parameterHandles.resonance;
+    voiceParameters.filterCutoffAmp = *parameterHandles.filterCutoffAmp;
+    voiceParameters.filterResonanceAmp = *parameterHandles.filterResonanceAmp;
 
-    //ladderFilter.process(juce::dsp::ProcessContextReplacing<float>(sampleBlock));
+    voiceParameters.filterEnvelope.attack = *parameterHandles.filterAttack;
+    voiceParameters.filterEnvelope.decay = *parameterHandles.filterDecay;
+    voiceParameters.filterEnvelope.sustain = *parameterHandles.filterSustain;
+    voiceParameters.filterEnvelope.release = *parameterHandles.filterRelease;
 
-    reverbParams.roomSize = *parameters.getRawParameterValue("room_size");
-    reverbParams.damping = *parameters.getRawParameterValue("damping");
-    reverbParams.dryLevel = *parameters.getRawParameterValue("dry");
-    reverbParams.wetLevel = *parameters.getRawParameterValue("wet");
-    
-    reverb.setParameters(reverbParams);
+    voiceParameters.lfoFreq = *parameterHandles.lfoFreq;
+    voiceParameters.lfoAmp = *parameterHandles.lfoAmp;
+    voiceParameters.lfoShape = int(*parameterHandles.lfoShape);
 
-    reverb.processStereo(buffer.getWritePointer(0), buffer.getWritePointer(1), buffer.getNumSamples());
+    // a group's count only moves on when one of its values has changed, which is all the voices look at
+    const auto& last = lastVoiceParameters;
 
+    auto envelopeChanged = [](const juce::ADSR::Parameters& a, const juce::ADSR::Parameters& b)
+    {
+        return a.attack != b.attack || a.decay != b.decay || a.sustain != b.sustain || a.release != b.release;
+    };
 
+    const bool changed[VoiceParameters::numGroups] =
+    {
+        voiceParameters.wavetableVolume != last.wavetableVolume || voiceParameters.sineVolume != last.sineVolume
+            || voiceParameters.stereoSpread != last.stereoSpread,
+        envelopeChanged(voiceParameters.envelope, last.envelope),
+        voiceParameters.cutoff != last.cutoff || voiceParameters.resonance != last.resonance
+            || voiceParameters.filterCutoffAmp != last.filterCutoffAmp || voiceParameters.filterResonanceAmp != last.filterResonanceAmp,
+        envelopeChanged(voiceParameters.filterEnvelope, last.filterEnvelope),
+        voiceParameters.lfoFreq != last.lfoFreq || voiceParameters.lfoAmp != last.lfoAmp || voiceParameters.lfoShape != last.lfoShape
+    };
+
+    for (int group = 0; group < VoiceParameters::numGroups; group++)
+        voiceParameters.changeCounts[group] = last.changeCounts[group] + (changed[group] ? 1 : 0);
+
+    return voiceParameters;
 }
 
 //==============================================================================
@@ -422,6 +525,31 @@ juce::AudioProcessorEditor* WavemorpherSynthesizerAudioProcessor::createEditor()
     return new WavemorpherSynthesizerAudioProcessorEditor (*this);
 }
 
+juce::StringArray WavemorpherSynthesizerAudioProcessor::getWavetableNames() const
+{
+    return WavetableBank::getWavetableNames(wavetableLibrary.get(), wavetableBuilder.getImportedWavetableNames());
+}
+
+juce::uint32 WavemorpherSynthesizerAudioProcessor::getNumWavetableImports() const
+{
+    return wavetableBuilder.getNumImports();
+}
+
+WavetableImporter& WavemorpherSynthesizerAudioProcessor::getWavetableImporter() noexcept
+{
+    return wavetableImporter;
+}
+
+void WavemorpherSynthesizerAudioProcessor::timerCallback()
+{
+    // the effects only switch mode in prepareToPlay, so rather than changing it mid stream from the audio thread,
+    // report the new latency from here, which prompts the host to prepare the plugin again
+    const int latencyWanted = *parameterHandles.pipelinedEffects >= 0.5f ? getBlockSize() : 0;
+
+    if (latencyWanted != getLatencySamples())
+        setLatencySamples(latencyWanted);
+}
+
 //==============================================================================
 void WavemorpherSynthesizerAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
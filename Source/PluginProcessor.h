@@ -12,11 +12,17 @@
 #include "WavetableOscillator.h"
 #include <BinaryData.h>
 #include "WavetableSynthesiser.h"
+#include "WavetableBuilder.h"
+#include "WavetableImporter.h"
+#include "Oscillators.h"
+#include "SendEffects.h"
+#include "ParameterRamps.h"
 
 //==============================================================================
 /**
 */
-class WavemorpherSynthesizerAudioProcessor  : public juce::AudioProcessor
+class WavemorpherSynthesizerAudioProcessor  : public juce::AudioProcessor,
+                                               private juce::Timer
 {
 public:
     //==============================================================================
@@ -61,46 +67,110 @@ public:
     // Value Tree State object for storing parameters
     juce::AudioProcessorValueTreeState parameters;
 
+    /// Get the name of every wavetable the slots can choose from, by wavetable index, empty where there is none
+    juce::StringArray getWavetableNames() const;
+
+    /// Get how many times wavetables have been imported, so the editor can tell when the names have changed
+    juce::uint32 getNumWavetableImports() const;
+
+    /// Get the importer that loads wavetables from disk into the slots
+    WavetableImporter& getWavetableImporter() noexcept;
+
 private:
+    //==============================================================================
+    /// Look up every parameter the audio thread reads, once, so processBlock never searches for them by name
+    void cacheParameterHandles();
+
+    /// Report the latency of a change to the pipelined effects setting, on the message thread
+    void timerCallback() override;
+
+    /**
+     Render one quantum of the synthesiser, working out its parameters, lfo and ramps first
+
+     @param buffer referring to the quantum of the host's buffer
+     @param midi events in the quantum, timed from its start
+     @param wavetables for the voices this block
+     @param morph table for the voices this block, may be null
+     */
+    void renderQuantum(juce::AudioBuffer<float>& quantum, const juce::MidiBuffer& midi, WavescanTables* tables, MorphTable* morphTable);
+
+    /// Read this quantum's voice parameters, moving on the change count of each group whose values differ from the last quantum
+    VoiceParameters makeVoiceParameters();
+
+    /// Raw values of the parameters read by the audio thread, looked up once in the constructor
+    struct ParameterHandles
+    {
+        std::atomic<float>* wavescan = nullptr;
+        std::atomic<float>* waveSynth = nullptr;
+        std::atomic<float>* sineSynth = nullptr;
+        std::atomic<float>* stereoSpread = nullptr;
+        std::atomic<float>* attack = nullptr;
+        std::atomic<float>* decay = nullptr;
+        std::atomic<float>* sustain = nullptr;
+        std::atomic<float>* release = nullptr;
+        std::atomic<float>* cutoff = nullptr;
+        std::atomic<float>* resonance = nullptr;
+        std::atomic<float>* filterAttack = nullptr;
+        std::atomic<float>* filterDecay = nullptr;
+        std::atomic<float>* filterSustain = nullptr;
+        std::atomic<float>* filterRelease = nullptr;
+        std::atomic<float>* filterCutoffAmp = nullptr;
+        std::atomic<float>* filterResonanceAmp = nullptr;
+        std::atomic<float>* controlRate = nullptr;
+        std::atomic<float>* chorusDepth = nullptr;
+        std::atomic<float>* chorusMix = nullptr;
+        std::atomic<float>* pipelinedEffects = nullptr;
+        std::atomic<float>* roomSize = nullptr;
+        std::atomic<float>* damping = nullptr;
+        std::atomic<float>* dry = nullptr;
+        std::atomic<float>* wet = nullptr;
+        std::atomic<float>* lfoShape = nullptr;
+        std::atomic<float>* lfoFreq = nullptr;
+        std::atomic<float>* lfoAmp = nullptr;
+        std::atomic<float>* lfoMode = nullptr;
+        std::atomic<float>* polyphony = nullptr;
+        std::atomic<float>* voiceStealing = nullptr;
+        std::atomic<float>* multicore = nullptr;
+        std::atomic<float>* eventGrid = nullptr;
+    };
+
+    ParameterHandles parameterHandles;
+
+    /// Voice parameters given to the synthesizer last quantum, to tell which have changed
+    VoiceParameters lastVoiceParameters;
+
+    /// Number of samples the synthesiser renders at a time, the host's blocks are worked through in quanta this size
+    static constexpr int quantumSize = 64;
+
+    /// Midi events of the quantum being rendered, timed from its start
+    juce::MidiBuffer quantumMidi;
+
     /// Main instance of the synthesizer class
-    juce::Synthesiser synth;
-
-    /// Number of voices the synthesizer has
-    int voiceCount = 10;
-
-    /// Gain used in process block
-    float gain = 0.25f;
-
-    /// Variable for the current index of the wavetable in BinaryData for wavescanning slot 1
-    float slotOneIndexCurrent;
-    /// Variable for the current index of the wavetable in BinaryData for wavescanning slot 2
-    float slotTwoIndexCurrent;
-    /// Variable for the current index of the wavetable in BinaryData for wavescanning slot 3
-    float slotThreeIndexCurrent;
-    /// Variable for the current index of the wavetable in BinaryData for wavescanning slot 4
-    float slotFourIndexCurrent;
-    /// Variable for the current index of the wavetable in BinaryData for wavescanning slot 5
-    float slotFiveIndexCurrent;
-
-    /// Variable of current index of the wavetable in BinaryData for wavescanning slot 1 updated from GUI
-    float slotOneIndexGUI;
-    /// Variable of current index of the wavetable in BinaryData for wavescanning slot 2 updated from GUI
-    float slotTwoIndexGUI;
-    /// Variable of current index of the wavetable in BinaryData for wavescanning slot 3 updated from GUI
-    float slotThreeIndexGUI;
-    /// Variable of current index of the wavetable in BinaryData for wavescanning slot 4 updated from GUI
-    float slotFourIndexGUI;
-    /// Variable of current index of the wavetable in BinaryData for wavescanning slot 5 updated from GUI
-    float slotFiveIndexGUI;
-
-    /// Juce reverb
-    juce::Reverb reverb;
-
-    /// Parameters of the reverb
-    juce::Reverb::Parameters reverbParams;
-
-    /// Juce DSP Chorus
-    juce::dsp::Chorus<float> chorus;
+    WavetableSynthesiser synth;
+
+    /// Library of wavetables opened at start up, whose tables follow the factory ones, null if there isn't one
+    WavetableLibrary::Ptr wavetableLibrary;
+
+    /// Builds the wavetables for the slots in the background and publishes them to the voices
+    WavetableBuilder wavetableBuilder;
+
+    /// Decodes and builds wavetables imported from disk on its own threads, then hands them to the builder
+    WavetableImporter wavetableImporter;
+
+    /// LFO shared by every voice in global lfo mode
+    BlockLfo globalLfo;
+
+    /// One quantum of the global LFO, read by all the voices
+    juce::AudioBuffer<float> globalLfoBuffer;
+
+    /// Change count of the lfo parameters last given to the global LFO
+    juce::uint32 globalLfoChangeCount = ~0u;
+
+    /// Per sample smoothing of the wavescan, mixer and filter parameters, shared by every voice
+    ParameterRamps parameterRamps;
+
+    /// Chorus and reverb, run after the synthesizer either inline or on their own thread
+    SendEffects sendEffects;
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WavemorpherSynthesizerAudioProcessor)
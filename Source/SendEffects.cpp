@@ -0,0 +1,271 @@
+/*
+  ==============================================================================
+
+    SendEffects.cpp
+    Part of WavemorpherSynthesizer project
+
+    Created: 17th October 2026
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#include "SendEffects.h"
+
+SendEffects::SendEffects()
+    : juce::Thread("Send Effects")
+{
+}
+
+SendEffects::~SendEffects()
+{
+    release();
+}
+
+void SendEffects::prepare(double sampleRate, int maximumBlockSize, int numChannels, bool shouldBePipelined)
+{
+    release();
+
+    blockSize = maximumBlockSize;
+    pipelined = shouldBePipelined;
+
+    // Preparation for the chorus, giving it the sample rate, samples per block and number of channels
+    juce::dsp::ProcessSpec spec;
+    spec.maximumBlockSize = (juce::uint32)maximumBlockSize;
+    spec.sampleRate = sampleRate;
+    spec.numChannels = (juce::uint32)numChannels;
+    chorus.prepare(spec);
+    chorus.reset();
+
+    // Preparing the reverb with a reset
+    reverb.setSampleRate(sampleRate);
+    reverb.reset();
+
+    for (auto& slot : handoverSlots)
+        slot.buffer.setSize(numChannels, maxBlocksPerHandover * maximumBlockSize);
+
+    // room for the block of latency plus the block being added before one is taken out
+    delayLine.setSize(numChannels, 2 * maximumBlockSize);
+    resetPipeline();
+
+    // real time, the effects are on the audio path, or as near as the system allows
+    if (pipelined && !startRealtimeThread(juce::Thread::RealtimeOptions().withPriority(10)))
+        startThread(juce::Thread::Priority::highest);
+}
+
+void SendEffects::release()
+{
+    signalThreadShouldExit();
+    blockReady.signal();
+    stopThread(1000);
+
+    for (auto& slot : handoverSlots)
+        slot.state.store(handoverFree);
+}
+
+int SendEffects::getLatencySamples() const noexcept
+{
+    return pipelined ? blockSize : 0;
+}
+
+void SendEffects::process(juce::AudioBuffer<float>& buffer, const Parameters& parameters)
+{
+    const int numSamples = buffer.getNumSamples();
+
+    if (!pipelined)
+    {
+        processEffects(buffer, 0, numSamples, parameters);
+        return;
+    }
+
+    jassert(numSamples <= blockSize);
+
+    // without the effects thread they run here, still going through the delay line so the latency reported holds
+    if (!isThreadRunning())
+    {
+        processEffects(buffer, 0, numSamples, parameters);
+        pushDelayLine(buffer, numSamples);
+        popDelayLine(buffer, numSamples);
+        return;
+    }
+
+    // collect whatever the effects thread has finished, never waiting for it
+    for (auto& slot : handoverSlots)
+        if (slot.state.load(std::memory_order_acquire) == handoverDone)
+            collect(slot);
+
+    // every block goes into the delay line dry, so there is something to output if the effects aren't back in time
+    const auto start = pushDelayLine(buffer, numSamples);
+    handOver(buffer, numSamples, parameters, start);
+
+    // and output the samples from one block ago
+    popDelayLine(buffer, numSamples);
+}
+
+void SendEffects::handOver(const juce::AudioBuffer<float>& buffer, int numSamples, const Parameters& parameters, juce::int64 delayLineStart)
+{
+    const int numChannels = juce::jmin(buffer.getNumChannels(), handoverSlots[0].buffer.getNumChannels());
+
+    // a second go covers the effects thread finishing the next buffer while it is being checked
+    for (int attempt = 0; attempt < 2; attempt++)
+    {
+        auto& slot = handoverSlots[nextSlotToFill];
+
+        if (slot.state.load(std::memory_order_acquire) == handoverDone)
+            collect(slot);
+
+        if (slot.state.load(std::memory_order_relaxed) == handoverFree)
+        {
+            for (int channel = 0; channel < numChannels; channel++)
+                slot.buffer.copyFrom(channel, 0, buffer, channel, 0, numSamples);
+
+            slot.numSamples = numSamples;
+            slot.parameters = parameters;
+            slot.delayLineStart = delayLineStart;
+            slot.state.store(handoverWaiting, std::memory_order_release);
+
+            nextSlotToFill ^= 1;
+            blockReady.signal();
+            return;
+        }
+
+        // both are taken, so add the block to the one handed over last, as long as the effects thread hasn't started on it
+        auto& last = handoverSlots[nextSlotToFill ^ 1];
+        int expected = handoverWaiting;
+
+        if (last.state.compare_exchange_strong(expected, handoverFilling, std::memory_order_acquire))
+        {
+            // only a block that follows on from it and fits, beyond that the effects thread is hopelessly behind and this block skips them
+            if (last.delayLineStart + last.numSamples == delayLineStart && last.numSamples + numSamples <= last.buffer.getNumSamples())
+            {
+                for (int channel = 0; channel < numChannels; channel++)
+                    last.buffer.copyFrom(channel, last.numSamples, buffer, channel, 0, numSamples);
+
+                last.numSamples += numSamples;
+                last.parameters = parameters;
+            }
+
+            last.state.store(handoverWaiting, std::memory_order_release);
+            blockReady.signal();
+            return;
+        }
+    }
+}
+
+void SendEffects::collect(HandoverSlot& slot)
+{
+    // any of it that has already gone out dry is too late to use
+    const int alreadyOut = (int)juce::jlimit((juce::int64)0, (juce::int64)slot.numSamples, delayLineTaken - slot.delayLineStart);
+
+    if (alreadyOut < slot.numSamples)
+        writeDelayLine(slot.delayLineStart + alreadyOut, slot.buffer, alreadyOut, slot.numSamples - alreadyOut);
+
+    slot.state.store(handoverFree, std::memory_order_relaxed);
+}
+
+void SendEffects::run()
+{
+    while (!threadShouldExit())
+    {
+        blockReady.wait();
+
+        if (threadShouldExit())
+            return;
+
+        // work through the buffers in the order they were handed over, one being filled is picked up on its next signal
+        for (;;)
+        {
+            auto& slot = handoverSlots[nextSlotToProcess];
+            int expected = handoverWaiting;
+
+            if (!slot.state.compare_exchange_strong(expected, handoverProcessing, std::memory_order_acquire))
+                break;
+
+            // a maximum sized block at a time, which is all the chorus is prepared for
+            for (int offset = 0; offset < slot.numSamples; offset += blockSize)
+                processEffects(slot.buffer, offset, juce::jmin(blockSize, slot.numSamples - offset), slot.parameters);
+
+            slot.state.store(handoverDone, std::memory_order_release);
+            nextSlotToProcess ^= 1;
+        }
+    }
+}
+
+void SendEffects::processEffects(juce::AudioBuffer<float>& buffer, int startSample, int numSamples, const Parameters& parameters)
+{
+    chorus.setDepth(parameters.chorusDepth);
+    chorus.setMix(parameters.chorusMix);
+
+    juce::dsp::AudioBlock<float> sampleBlock(buffer);
+    auto blockToProcess = sampleBlock.getSubBlock((size_t)startSample, (size_t)numSamples);
+    chorus.process(juce::dsp::ProcessContextReplacing<float>(blockToProcess));
+
+    reverb.setParameters(parameters.reverb);
+
+    if (buffer.getNumChannels() >= 2)
+        reverb.processStereo(buffer.getWritePointer(0, startSample), buffer.getWritePointer(1, startSample), numSamples);
+    else
+        reverb.processMono(buffer.getWritePointer(0, startSample), numSamples);
+}
+
+juce::int64 SendEffects::pushDelayLine(const juce::AudioBuffer<float>& source, int numSamples)
+{
+    jassert(delayLineCount + numSamples <= delayLine.getNumSamples());
+
+    const auto start = delayLineTaken + delayLineCount;
+    delayLineCount += numSamples;
+    writeDelayLine(start, source, 0, numSamples);
+
+    return start;
+}
+
+void SendEffects::writeDelayLine(juce::int64 start, const juce::AudioBuffer<float>& source, int sourceStart, int numSamples)
+{
+    const int size = delayLine.getNumSamples();
+    jassert(start >= delayLineTaken && start + numSamples <= delayLineTaken + delayLineCount);
+
+    // the write position wraps round, so copy in up to two pieces
+    const int writePosition = (delayLineRead + (int)(start - delayLineTaken)) % size;
+    const int firstPart = juce::jmin(numSamples, size - writePosition);
+    const int numChannels = juce::jmin(source.getNumChannels(), delayLine.getNumChannels());
+
+    for (int channel = 0; channel < numChannels; channel++)
+    {
+        delayLine.copyFrom(channel, writePosition, source, channel, sourceStart, firstPart);
+        delayLine.copyFrom(channel, 0, source, channel, sourceStart + firstPart, numSamples - firstPart);
+    }
+}
+
+void SendEffects::popDelayLine(juce::AudioBuffer<float>& dest, int numSamples)
+{
+    const int size = delayLine.getNumSamples();
+    jassert(numSamples <= delayLineCount);
+
+    const int firstPart = juce::jmin(numSamples, size - delayLineRead);
+    const int numChannels = juce::jmin(dest.getNumChannels(), delayLine.getNumChannels());
+
+    for (int channel = 0; channel < numChannels; channel++)
+    {
+        dest.copyFrom(channel, 0, delayLine, channel, delayLineRead, firstPart);
+        dest.copyFrom(channel, firstPart, delayLine, channel, 0, numSamples - firstPart);
+    }
+
+    delayLineRead = (delayLineRead + numSamples) % size;
+    delayLineCount -= numSamples;
+    delayLineTaken += numSamples;
+}
+
+void SendEffects::resetPipeline()
+{
+    for (auto& slot : handoverSlots)
+        slot.state.store(handoverFree);
+
+    nextSlotToFill = 0;
+    nextSlotToProcess = 0;
+
+    // one block of silence, so the output always has a block's worth ready
+    delayLine.clear();
+    delayLineRead = 0;
+    delayLineCount = blockSize;
+    delayLineTaken = 0;
+}
@@ -0,0 +1,160 @@
+/*
+  ==============================================================================
+
+    SendEffects.h
+    Part of WavemorpherSynthesizer project
+
+    Created: 17th October 2026
+    Author:  agent
+
+    Description: The chorus and reverb applied to the synthesiser's output.
+    They run on the audio thread straight after the voices, or in pipelined
+    mode on their own thread: each block is handed to the effects thread
+    and the effects for that block are done while the audio thread renders
+    the next one, so the voices and the effects overlap on two cores at the
+    cost of one block of latency. The audio thread never waits for the
+    effects thread. Blocks are handed over in two buffers used in turn, so
+    the next block can be handed over while the effects thread is still on
+    the last, and a block arriving while both are taken is added to the one
+    still waiting. Every block goes through the effects, keeping the chorus
+    and reverb running on unbroken input. Each block also goes into the
+    delay line dry and is overwritten with the processed samples once they
+    are back, so any of a block the effects thread is late with goes out
+    dry. If the effects thread can't be started the effects run inline,
+    still a block behind, so the latency reported stays true.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "WakeSignal.h"
+
+/*!
+ @class SendEffects
+ @abstract chorus and reverb stage, run either inline or pipelined on its own thread
+ @discussion in pipelined mode the output is delayed by exactly one maximum sized block, whatever the size of the blocks
+
+ @namespace none
+ */
+class SendEffects : private juce::Thread
+{
+public:
+    /// Values of the chorus and reverb parameters for one block
+    struct Parameters
+    {
+        float chorusDepth = 0.1f;
+        float chorusMix = 0.1f;
+        juce::Reverb::Parameters reverb;
+    };
+
+    SendEffects();
+    ~SendEffects() override;
+
+    //--------------------------------------------------------------------------
+    /**
+     Prepare the effects, and start the effects thread in pipelined mode, not to be called from the audio thread
+
+     @param sample rate
+     @param maximum number of samples in a block, and the latency of pipelined mode
+     @param number of output channels
+     @param true to run the effects on their own thread with one block of latency
+     */
+    void prepare(double sampleRate, int maximumBlockSize, int numChannels, bool shouldBePipelined);
+
+    //--------------------------------------------------------------------------
+    /**
+     Stop the effects thread, not to be called from the audio thread
+     */
+    void release();
+
+    //--------------------------------------------------------------------------
+    /**
+     Get the latency the effects add, one maximum sized block in pipelined mode and none otherwise
+     */
+    int getLatencySamples() const noexcept;
+
+    //--------------------------------------------------------------------------
+    /**
+     Apply the effects to a block of the synthesiser's output, in place
+
+     @param buffer holding the block
+     @param values of the effect parameters for this block
+     */
+    void process(juce::AudioBuffer<float>& buffer, const Parameters& parameters);
+
+private:
+    struct HandoverSlot;
+
+    //--------------------------------------------------------------------------
+    /// Effects thread, processes each block handed over until the thread is stopped
+    void run() override;
+
+    /// Apply the chorus then the reverb to part of a buffer, no longer than a maximum sized block
+    void processEffects(juce::AudioBuffer<float>& buffer, int startSample, int numSamples, const Parameters& parameters);
+
+    /// Add samples to the end of the delay line, returning where they start counted from the last reset, or take them from the front
+    juce::int64 pushDelayLine(const juce::AudioBuffer<float>& source, int numSamples);
+    void popDelayLine(juce::AudioBuffer<float>& dest, int numSamples);
+
+    /// Write over samples still waiting in the delay line, from where pushDelayLine said they start
+    void writeDelayLine(juce::int64 start, const juce::AudioBuffer<float>& source, int sourceStart, int numSamples);
+
+    /// Hand a block to the effects thread, in a free handover buffer or added to the one still waiting
+    void handOver(const juce::AudioBuffer<float>& buffer, int numSamples, const Parameters& parameters, juce::int64 delayLineStart);
+
+    /// Write a processed handover buffer over the dry samples in the delay line that haven't gone out yet, and free it
+    void collect(HandoverSlot& slot);
+
+    /// Drop everything in the pipeline and fill the delay line with one block of silence
+    void resetPipeline();
+
+    //--------------------------------------------------------------------------
+    /// Juce DSP Chorus
+    juce::dsp::Chorus<float> chorus;
+
+    /// Juce reverb
+    juce::Reverb reverb;
+
+    /// Is pipelined mode on
+    bool pipelined = false;
+
+    /// Maximum block size, the latency in pipelined mode
+    int blockSize = 0;
+
+    /// Most maximum sized blocks a handover buffer holds, blocks are added to one still waiting while the other is being processed
+    static constexpr int maxBlocksPerHandover = 4;
+
+    /// States of a handover buffer, only the thread the state gives it to touches the rest of it
+    enum HandoverState
+    {
+        handoverFree,       ///< audio thread's, nothing in it
+        handoverFilling,    ///< audio thread's, adding a block to one waiting
+        handoverWaiting,    ///< waiting for the effects thread
+        handoverProcessing, ///< effects thread's
+        handoverDone        ///< audio thread's, processed and waiting to be collected
+    };
+
+    /// Buffer blocks are handed to the effects thread in, with their parameters and where their dry copy starts in the delay line
+    struct HandoverSlot
+    {
+        juce::AudioBuffer<float> buffer;
+        int numSamples = 0;
+        Parameters parameters;
+        juce::int64 delayLineStart = 0;
+        std::atomic<int> state { handoverFree };
+    };
+
+    /// The two handover buffers, used in turn by both threads so the blocks are processed in the order they were handed over
+    HandoverSlot handoverSlots[2];
+    int nextSlotToFill = 0, nextSlotToProcess = 0;
+
+    /// Signalled when a block is handed over
+    WakeSignal blockReady;
+
+    /// Samples waiting to be output, one maximum sized block behind the input, and the number taken out since the last reset
+    juce::AudioBuffer<float> delayLine;
+    int delayLineRead = 0, delayLineCount = 0;
+    juce::int64 delayLineTaken = 0;
+};
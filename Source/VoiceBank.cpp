@@ -0,0 +1,327 @@
+/*
+  ==============================================================================
+
+    VoiceBank.cpp
+    Part of WavemorpherSynthesizer project
+
+    Created: 17th October 2026
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#include "VoiceBank.h"
+
+void VoiceBank::Envelopes::allocate(int numVoices)
+{
+    stage.calloc((size_t)numVoices);
+    level.calloc((size_t)numVoices);
+    attackRate.calloc((size_t)numVoices);
+    decayRate.calloc((size_t)numVoices);
+    sustainLevel.calloc((size_t)numVoices);
+    releaseTime.calloc((size_t)numVoices);
+    releaseRate.calloc((size_t)numVoices);
+}
+
+void VoiceBank::prepare(double sampleRate, int numVoicesToUse)
+{
+    // setting sample rate for later use
+    SR = sampleRate;
+    numVoices = numVoicesToUse;
+
+    amplitude.allocate(numVoices);
+    filter.allocate(numVoices);
+
+    fundamentalPhase.calloc((size_t)numVoices);
+    fundamentalDelta.calloc((size_t)numVoices);
+    wavetableVolume.calloc((size_t)numVoices);
+    sineVolume.calloc((size_t)numVoices);
+    released.calloc((size_t)numVoices);
+
+    // juce::ADSR's default parameters until the processor hands over the real ones
+    for (int voice = 0; voice < numVoices; voice++)
+    {
+        setAmplitudeEnvelope(voice, {});
+        setFilterEnvelope(voice, {});
+        setVolumes(voice, 1.0f, 1.0f);
+    }
+}
+
+void VoiceBank::noteOn(int voice, float frequency) noexcept
+{
+    startEnvelope(amplitude, voice);
+    startEnvelope(filter, voice);
+    released[voice] = false;
+
+    // the fundamental keeps its phase from the last note, like the SinOsc it replaces
+    setFrequency(voice, frequency);
+}
+
+void VoiceBank::setFrequency(int voice, float frequency) noexcept
+{
+    fundamentalDelta[voice] = (float)(frequency / SR);
+}
+
+void VoiceBank::noteOff(int voice) noexcept
+{
+    releaseEnvelope(amplitude, voice);
+    releaseEnvelope(filter, voice);
+    released[voice] = true;
+}
+
+bool VoiceBank::isFinished(int voice) const noexcept
+{
+    // the same threshold the voice used to check every sample
+    return released[voice] && amplitude.level[voice] < 0.0001f;
+}
+
+bool VoiceBank::isReleased(int voice) const noexcept
+{
+    return released[voice];
+}
+
+float VoiceBank::getAmplitudeEnvelope(int voice) const noexcept
+{
+    return amplitude.level[voice];
+}
+
+float VoiceBank::getFilterEnvelope(int voice) const noexcept
+{
+    return filter.level[voice];
+}
+
+void VoiceBank::setAmplitudeEnvelope(int voice, const juce::ADSR::Parameters& parameters) noexcept
+{
+    setEnvelope(amplitude, voice, parameters);
+}
+
+void VoiceBank::setFilterEnvelope(int voice, const juce::ADSR::Parameters& parameters) noexcept
+{
+    setEnvelope(filter, voice, parameters);
+}
+
+void VoiceBank::setVolumes(int voice, float newWavetableVolume, float newSineVolume) noexcept
+{
+    wavetableVolume[voice] = newWavetableVolume;
+    sineVolume[voice] = newSineVolume;
+}
+
+void VoiceBank::setVolumeRamps(const float* newWavetableVolumeRamp, const float* newSineVolumeRamp) noexcept
+{
+    wavetableVolumeRamp = newWavetableVolumeRamp;
+    sineVolumeRamp = newSineVolumeRamp;
+}
+
+void VoiceBank::process(float* const* voiceChannels, const int* voices, int numVoicesToProcess, int startSample, int numSamples) noexcept
+{
+    float envelope[chunkSize], fundamental[chunkSize], steadyVolumes[chunkSize];
+
+    // every listed voice is taken a chunk at a time, so the scratch buffers and the voice state stay in cache
+    for (int chunkStart = startSample; chunkStart < startSample + numSamples; chunkStart += chunkSize)
+    {
+        const int chunkLength = juce::jmin(chunkSize, startSample + numSamples - chunkStart);
+
+        for (int listed = 0; listed < numVoicesToProcess; listed++)
+        {
+            const int voice = voices[listed];
+            auto* samples = voiceChannels[voice] + chunkStart;
+
+            renderEnvelope(amplitude, voice, envelope, chunkLength);
+
+            // fundamental sine, each sample's phase is worked out from the start of the chunk so the loop has no dependencies
+            const float phase = fundamentalPhase[voice];
+            const float delta = fundamentalDelta[voice];
+
+            for (int i = 0; i < chunkLength; i++)
+            {
+                const float p = phase + (float)(i + 1) * delta;
+                fundamental[i] = sinTwoPi(p - (float)(int)p);
+            }
+
+            const float endPhase = phase + (float)chunkLength * delta;
+            fundamentalPhase[voice] = endPhase - (float)(int)endPhase;
+
+            // mix the wavetable and the fundamental, both shaped by the envelope, scaled by 0.5 so that it is not too loud by default
+            if (wavetableVolumeRamp == nullptr && sineVolumeRamp == nullptr)
+            {
+                const float wtVolume = wavetableVolume[voice];
+                const float fundamentalVolume = sineVolume[voice];
+
+                for (int i = 0; i < chunkLength; i++)
+                    samples[i] = ((samples[i] * wtVolume) + (fundamental[i] * fundamentalVolume)) * envelope[i] * 0.5f;
+            }
+            else
+            {
+                // while either level is moving both are read per sample, a steady one is just filled with its value
+                const float* wtVolumes = wavetableVolumeRamp != nullptr ? wavetableVolumeRamp + chunkStart : steadyVolumes;
+                const float* fundamentalVolumes = sineVolumeRamp != nullptr ? sineVolumeRamp + chunkStart : steadyVolumes;
+
+                if (wavetableVolumeRamp == nullptr)
+                    juce::FloatVectorOperations::fill(steadyVolumes, wavetableVolume[voice], chunkLength);
+                else if (sineVolumeRamp == nullptr)
+                    juce::FloatVectorOperations::fill(steadyVolumes, sineVolume[voice], chunkLength);
+
+                for (int i = 0; i < chunkLength; i++)
+                    samples[i] = ((samples[i] * wtVolumes[i]) + (fundamental[i] * fundamentalVolumes[i])) * envelope[i] * 0.5f;
+            }
+
+            // only the filter envelope's value at the end of the block is needed, but it moves on by the same amount
+            renderEnvelope(filter, voice, envelope, chunkLength);
+        }
+    }
+}
+
+//==============================================================================
+// ENVELOPES
+
+void VoiceBank::setEnvelope(Envelopes& envelopes, int voice, const juce::ADSR::Parameters& parameters) noexcept
+{
+    // same as juce::ADSR::recalculateRates, a negative rate means the stage is skipped
+    auto getRate = [this](float distance, float timeInSeconds)
+    {
+        return timeInSeconds > 0.0f ? (float)(distance / (timeInSeconds * SR)) : -1.0f;
+    };
+
+    envelopes.attackRate[voice] = getRate(1.0f, parameters.attack);
+    envelopes.decayRate[voice] = getRate(1.0f - parameters.sustain, parameters.decay);
+    envelopes.sustainLevel[voice] = parameters.sustain;
+    envelopes.releaseTime[voice] = parameters.release;
+
+    // move on from any stage that has just been turned off
+    auto& stage = envelopes.stage[voice];
+
+    if (stage == attack && envelopes.attackRate[voice] <= 0.0f)
+        stage = envelopes.decayRate[voice] > 0.0f ? decay : sustain;
+    else if (stage == decay && (envelopes.decayRate[voice] <= 0.0f || envelopes.level[voice] <= parameters.sustain))
+        stage = sustain;
+}
+
+void VoiceBank::startEnvelope(Envelopes& envelopes, int voice) noexcept
+{
+    envelopes.level[voice] = 0.0f;
+
+    if (envelopes.attackRate[voice] > 0.0f)
+    {
+        envelopes.stage[voice] = attack;
+    }
+    else if (envelopes.decayRate[voice] > 0.0f)
+    {
+        envelopes.level[voice] = 1.0f;
+        envelopes.stage[voice] = decay;
+    }
+    else
+    {
+        envelopes.level[voice] = envelopes.sustainLevel[voice];
+        envelopes.stage[voice] = sustain;
+    }
+}
+
+void VoiceBank::releaseEnvelope(Envelopes& envelopes, int voice) noexcept
+{
+    if (envelopes.stage[voice] == idle)
+        return;
+
+    // nothing to release from, a ramp from zero would have no rate to cover it at
+    if (envelopes.releaseTime[voice] > 0.0f && envelopes.level[voice] > 0.0f)
+    {
+        // releases from wherever the envelope has got to over the release time
+        envelopes.releaseRate[voice] = (float)(envelopes.level[voice] / (envelopes.releaseTime[voice] * SR));
+        envelopes.stage[voice] = release;
+    }
+    else
+    {
+        envelopes.level[voice] = 0.0f;
+        envelopes.stage[voice] = idle;
+    }
+}
+
+void VoiceBank::renderEnvelope(Envelopes& envelopes, int voice, float* dest, int numSamples) noexcept
+{
+    auto& stage = envelopes.stage[voice];
+    auto& level = envelopes.level[voice];
+
+    // samples until a ramp covers a distance, the last of them lands exactly on the end of the stage,
+    // a ramp that doesn't move jumps straight there
+    auto samplesToCover = [](float distance, float rate, int samplesLeft)
+    {
+        if (!(rate > 0.0f))
+            return 1;
+
+        return juce::jmax(1, (int)juce::jmin(std::ceil(distance / rate), (float)samplesLeft));
+    };
+
+    int sample = 0;
+
+    while (sample < numSamples)
+    {
+        const int samplesLeft = numSamples - sample;
+
+        switch (stage)
+        {
+        case attack:
+        {
+            const int length = samplesToCover(1.0f - level, envelopes.attackRate[voice], samplesLeft + 1);
+            const int rampLength = juce::jmin(length - 1, samplesLeft);
+            level = fillRamp(dest + sample, rampLength, level, envelopes.attackRate[voice]);
+            sample += rampLength;
+
+            if (sample < numSamples)
+            {
+                level = 1.0f;
+                dest[sample++] = level;
+                stage = envelopes.decayRate[voice] > 0.0f ? decay : sustain;
+            }
+            break;
+        }
+        case decay:
+        {
+            const float sustainLevel = envelopes.sustainLevel[voice];
+            const int length = samplesToCover(level - sustainLevel, envelopes.decayRate[voice], samplesLeft + 1);
+            const int rampLength = juce::jmin(length - 1, samplesLeft);
+            level = fillRamp(dest + sample, rampLength, level, -envelopes.decayRate[voice]);
+            sample += rampLength;
+
+            if (sample < numSamples)
+            {
+                level = sustainLevel;
+                dest[sample++] = level;
+                stage = sustain;
+            }
+            break;
+        }
+        case sustain:
+            level = envelopes.sustainLevel[voice];
+            juce::FloatVectorOperations::fill(dest + sample, level, samplesLeft);
+            sample = numSamples;
+            break;
+        case release:
+        {
+            const int length = samplesToCover(level, envelopes.releaseRate[voice], samplesLeft + 1);
+            const int rampLength = juce::jmin(length - 1, samplesLeft);
+            level = fillRamp(dest + sample, rampLength, level, -envelopes.releaseRate[voice]);
+            sample += rampLength;
+
+            if (sample < numSamples)
+            {
+                level = 0.0f;
+                dest[sample++] = level;
+                stage = idle;
+            }
+            break;
+        }
+        default:
+            level = 0.0f;
+            juce::FloatVectorOperations::clear(dest + sample, samplesLeft);
+            sample = numSamples;
+            break;
+        }
+    }
+}
+
+float VoiceBank::fillRamp(float* dest, int numSamples, float level, float rate) noexcept
+{
+    for (int i = 0; i < numSamples; i++)
+        dest[i] = level + (float)(i + 1) * rate;
+
+    return level + (float)numSamples * rate;
+}
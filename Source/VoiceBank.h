@@ -0,0 +1,232 @@
+/*
+  ==============================================================================
+
+    VoiceBank.h
+    Part of WavemorpherSynthesizer project
+
+    Created: 17th October 2026
+    Author:  agent
+
+    Description: The per sample state of every voice kept together in
+    contiguous arrays (structure of arrays) rather than spread across the
+    voice objects: amplitude and filter envelopes, the fundamental sine
+    oscillator and the mixer levels. Voices only render their wavetable
+    oscillators, the bank then applies the envelopes, adds the fundamental
+    and mixes, working through every active voice a short chunk of samples
+    at a time so everything it touches stays in cache.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/*!
+ @class VoiceBank
+ @abstract envelopes, fundamental oscillator and mixer for every voice of the synthesiser
+ @discussion the envelopes follow juce::ADSR, but are rendered a linear segment at a time instead of sample by sample
+
+ @namespace none
+ */
+class VoiceBank
+{
+public:
+    /// Number of samples worked through for every voice before moving on to the next chunk
+    static constexpr int chunkSize = 32;
+
+    //--------------------------------------------------------------------------
+    /**
+     Allocate the state of every voice, not to be called from the audio thread
+
+     @param sample rate
+     @param number of voices in the bank
+     */
+    void prepare(double sampleRate, int numVoices);
+
+    //--------------------------------------------------------------------------
+    /**
+     Start the envelopes of a voice from zero and set its fundamental frequency
+
+     @param index of the voice in the bank
+     @param frequency of the note in Hz
+     */
+    void noteOn(int voice, float frequency) noexcept;
+
+    //--------------------------------------------------------------------------
+    /**
+     Change the frequency of a voice's fundamental without restarting it, for pitch bends
+
+     @param index of the voice in the bank
+     @param new frequency in Hz
+     */
+    void setFrequency(int voice, float frequency) noexcept;
+
+    //--------------------------------------------------------------------------
+    /**
+     Put both envelopes of a voice into their release
+
+     @param index of the voice in the bank
+     */
+    void noteOff(int voice) noexcept;
+
+    //--------------------------------------------------------------------------
+    /**
+     Has a released voice's amplitude envelope faded out, so the note can be cleared
+
+     @param index of the voice in the bank
+     */
+    bool isFinished(int voice) const noexcept;
+
+    //--------------------------------------------------------------------------
+    /**
+     Has a voice been released since its last note on
+
+     @param index of the voice in the bank
+     */
+    bool isReleased(int voice) const noexcept;
+
+    //--------------------------------------------------------------------------
+    /**
+     Get the value of a voice's amplitude envelope at the end of the last block processed
+
+     @param index of the voice in the bank
+     */
+    float getAmplitudeEnvelope(int voice) const noexcept;
+
+    //--------------------------------------------------------------------------
+    /**
+     Get the value of a voice's filter envelope at the end of the last block processed
+
+     @param index of the voice in the bank
+     */
+    float getFilterEnvelope(int voice) const noexcept;
+
+    //--------------------------------------------------------------------------
+    /**
+     Update the amplitude envelope of a voice, with the same parameters as juce::ADSR
+
+     @param index of the voice in the bank
+     @param attack, decay and release times in seconds and sustain level
+     */
+    void setAmplitudeEnvelope(int voice, const juce::ADSR::Parameters& parameters) noexcept;
+
+    //--------------------------------------------------------------------------
+    /**
+     Update the filter envelope of a voice, with the same parameters as juce::ADSR
+
+     @param index of the voice in the bank
+     @param attack, decay and release times in seconds and sustain level
+     */
+    void setFilterEnvelope(int voice, const juce::ADSR::Parameters& parameters) noexcept;
+
+    //--------------------------------------------------------------------------
+    /**
+     Set the mixer levels of a voice
+
+     @param index of the voice in the bank
+     @param wavetable oscillator volume level
+     @param fundamental sinusoidal oscillator volume level
+     */
+    void setVolumes(int voice, float wavetableVolume, float sineVolume) noexcept;
+
+    //--------------------------------------------------------------------------
+    /**
+     Set the smoothed mixer levels for the block, used by every voice instead of its own levels while they are moving
+
+     @param per sample wavetable oscillator volume levels for the whole block, or null to use each voice's level
+     @param per sample fundamental volume levels for the whole block, or null to use each voice's level
+     */
+    void setVolumeRamps(const float* wavetableVolumeRamp, const float* sineVolumeRamp) noexcept;
+
+    //--------------------------------------------------------------------------
+    /**
+     Turn the wavetable output of the listed voices into the voices' output
+
+     Applies the amplitude envelope, adds the fundamental and mixes the two,
+     in place, and moves the filter envelopes on by the same number of samples.
+     Only the listed voices are touched, so idle voices cost nothing
+
+     @param one channel per voice holding the wavetable output of the voice
+     @param indices of the voices that rendered this block
+     @param number of indices in the list
+     @param first sample of the channels to process
+     @param number of samples to process
+     */
+    void process(float* const* voiceChannels, const int* voices, int numVoicesToProcess, int startSample, int numSamples) noexcept;
+
+private:
+    //--------------------------------------------------------------------------
+    /// Stages of the envelopes, the same as juce::ADSR
+    enum Stage
+    {
+        idle = 0,
+        attack,
+        decay,
+        sustain,
+        release
+    };
+
+    /// State of one kind of envelope for every voice, one entry per voice in each array
+    struct Envelopes
+    {
+        juce::HeapBlock<int> stage;
+        juce::HeapBlock<float> level;
+        juce::HeapBlock<float> attackRate, decayRate, sustainLevel, releaseTime, releaseRate;
+
+        void allocate(int numVoices);
+    };
+
+    /// Work out the per sample rates of an envelope from its parameters, the same way as juce::ADSR
+    void setEnvelope(Envelopes& envelopes, int voice, const juce::ADSR::Parameters& parameters) noexcept;
+
+    /// Start an envelope from zero
+    static void startEnvelope(Envelopes& envelopes, int voice) noexcept;
+
+    /// Release an envelope, or stop it straight away if it has no release time
+    void releaseEnvelope(Envelopes& envelopes, int voice) noexcept;
+
+    /// Write the next samples of an envelope, filling whole linear segments at a time
+    static void renderEnvelope(Envelopes& envelopes, int voice, float* dest, int numSamples) noexcept;
+
+    /// Fill dest with a ramp that carries on from level, returning where the ramp ends
+    static float fillRamp(float* dest, int numSamples, float level, float rate) noexcept;
+
+    /// sin(2 pi p) for a phase between 0 and 1, a polynomial accurate to a few parts in a million
+    static forcedinline float sinTwoPi(float p) noexcept
+    {
+        // sin(2 pi p) is -sin(x) for x = 2 pi (p - 0.5), x is folded into +-pi/2 where the polynomial is accurate
+        constexpr float pi = juce::MathConstants<float>::pi;
+        constexpr float halfPi = juce::MathConstants<float>::halfPi;
+
+        float x = (p - 0.5f) * juce::MathConstants<float>::twoPi;
+        x = x > halfPi ? pi - x : x;
+        x = x < -halfPi ? -pi - x : x;
+
+        const float x2 = x * x;
+        return -x * (1.0f + x2 * (-1.0f / 6.0f + x2 * (1.0f / 120.0f + x2 * (-1.0f / 5040.0f + x2 * (1.0f / 362880.0f)))));
+    }
+
+    //--------------------------------------------------------------------------
+    /// Amplitude and filter envelopes of every voice
+    Envelopes amplitude, filter;
+
+    /// Phase and per sample phase increment of every voice's fundamental oscillator
+    juce::HeapBlock<float> fundamentalPhase, fundamentalDelta;
+
+    /// Wavetable and fundamental mixer levels of every voice
+    juce::HeapBlock<float> wavetableVolume, sineVolume;
+
+    /// Smoothed mixer levels for the current block shared by every voice, null while the level is steady
+    const float* wavetableVolumeRamp = nullptr;
+    const float* sineVolumeRamp = nullptr;
+
+    /// Whether each voice has been released
+    juce::HeapBlock<bool> released;
+
+    /// Number of voices in the bank
+    int numVoices = 0;
+
+    /// Storing sample rate
+    double SR = 44100.0;
+};
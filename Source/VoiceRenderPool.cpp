@@ -0,0 +1,215 @@
+/*
+  ==============================================================================
+
+    VoiceRenderPool.cpp
+    Part of WavemorpherSynthesizer project
+
+    Created: 17th October 2026
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#include "VoiceRenderPool.h"
+
+#if JUCE_INTEL
+ #include <immintrin.h>
+#endif
+
+/// Tell the core this thread is spinning, so it doesn't hog the pipeline from a sibling hyperthread
+static forcedinline void spinPause() noexcept
+{
+   #if JUCE_INTEL
+    _mm_pause();
+   #elif JUCE_ARM && JUCE_MSVC
+    __yield();
+   #elif JUCE_ARM
+    asm volatile ("yield");
+   #endif
+}
+
+VoiceRenderPool::~VoiceRenderPool()
+{
+    stop();
+}
+
+void VoiceRenderPool::start(int numWorkersToStart)
+{
+    stop();
+
+    for (auto& range : ranges)
+        range.store(packRange(0, 0));
+
+    numWorkersToStart = juce::jlimit(0, maxWorkers, numWorkersToStart);
+
+    for (int i = 0; i < numWorkersToStart; i++)
+    {
+        auto* worker = workers.add(new Worker(*this, i + 1));
+
+        // real time, the workers are doing the audio thread's job, or as near as the system allows
+        if (!worker->startRealtimeThread(juce::Thread::RealtimeOptions().withPriority(10)))
+            worker->startThread(juce::Thread::Priority::highest);
+    }
+
+    numParticipants.store(workers.size() + 1);
+
+    // only now can the audio thread hand batches to the workers
+    if (!workers.isEmpty())
+        workersRunning.store(true);
+}
+
+void VoiceRenderPool::stop()
+{
+    // no new batch can use the workers once this is clear, so wait for one that already is
+    workersRunning.store(false);
+
+    while (batchRunning.load())
+        juce::Thread::yield();
+
+    for (auto* worker : workers)
+    {
+        worker->signalThreadShouldExit();
+        worker->wake();
+    }
+
+    for (auto* worker : workers)
+        worker->stopThread(1000);
+
+    workers.clear();
+    numParticipants.store(1);
+}
+
+bool VoiceRenderPool::isRunning() const noexcept
+{
+    return workersRunning.load();
+}
+
+bool VoiceRenderPool::run(Jobs& jobs, int numJobs) noexcept
+{
+    // stop() can't delete the workers while this is set, and if they are already being stopped the caller runs the jobs
+    batchRunning.store(true);
+
+    if (!workersRunning.load())
+    {
+        batchRunning.store(false);
+        return false;
+    }
+
+    const int participants = numParticipants.load();
+
+    // the batch has to be in place before any range is, a worker only looks at it once it has taken a job
+    currentJobs.store(&jobs, std::memory_order_relaxed);
+    jobsFinished.store(0, std::memory_order_relaxed);
+
+    // split the jobs into a contiguous range for each participant
+    for (int p = 0; p < participants; p++)
+    {
+        const auto begin = (juce::uint32)(numJobs * p / participants);
+        const auto end = (juce::uint32)(numJobs * (p + 1) / participants);
+        ranges[p].store(packRange(begin, end), std::memory_order_release);
+    }
+
+    for (auto* worker : workers)
+        worker->wake();
+
+    // this thread works too, so the batch finishes even if none of the workers wake up in time
+    work(0);
+
+    // nothing is left to take or steal, so this only waits for jobs a worker is already part way through,
+    // which can't be taken over as they write to the same voices, at most one job per worker
+    for (int spins = 1; jobsFinished.load(std::memory_order_acquire) < numJobs; spins++)
+    {
+        spinPause();
+
+        // let a worker that has been descheduled back onto the core
+        if (spins % 256 == 0)
+            juce::Thread::yield();
+    }
+
+    batchRunning.store(false);
+    return true;
+}
+
+void VoiceRenderPool::work(int participant) noexcept
+{
+    const int participants = numParticipants.load();
+
+    for (;;)
+    {
+        int job = takeJob(participant);
+
+        // own range is empty, go round the others looking for a job to steal
+        for (int i = 1; job < 0 && i < participants; i++)
+            job = stealJob((participant + i) % participants);
+
+        if (job < 0)
+            return;
+
+        currentJobs.load(std::memory_order_acquire)->runJob(job, participant);
+        jobsFinished.fetch_add(1, std::memory_order_release);
+    }
+}
+
+int VoiceRenderPool::takeJob(int participant) noexcept
+{
+    auto& range = ranges[participant];
+    auto current = range.load(std::memory_order_acquire);
+
+    for (;;)
+    {
+        const auto begin = (juce::uint32)current;
+        const auto end = (juce::uint32)(current >> 32);
+
+        if (begin >= end)
+            return -1;
+
+        if (range.compare_exchange_weak(current, packRange(begin + 1, end), std::memory_order_acq_rel, std::memory_order_acquire))
+            return (int)begin;
+    }
+}
+
+int VoiceRenderPool::stealJob(int victim) noexcept
+{
+    auto& range = ranges[victim];
+    auto current = range.load(std::memory_order_acquire);
+
+    for (;;)
+    {
+        const auto begin = (juce::uint32)current;
+        const auto end = (juce::uint32)(current >> 32);
+
+        if (begin >= end)
+            return -1;
+
+        if (range.compare_exchange_weak(current, packRange(begin, end - 1), std::memory_order_acq_rel, std::memory_order_acquire))
+            return (int)end - 1;
+    }
+}
+
+//==============================================================================
+// WORKER
+
+VoiceRenderPool::Worker::Worker(VoiceRenderPool& _pool, int _participant)
+    : juce::Thread("Voice Render Worker " + juce::String(_participant)),
+      pool(_pool),
+      participant(_participant)
+{
+}
+
+void VoiceRenderPool::Worker::wake() noexcept
+{
+    batchStarted.signal();
+}
+
+void VoiceRenderPool::Worker::run()
+{
+    while (!threadShouldExit())
+    {
+        batchStarted.wait();
+
+        if (threadShouldExit())
+            return;
+
+        pool.work(participant);
+    }
+}
@@ -0,0 +1,165 @@
+/*
+  ==============================================================================
+
+    VoiceRenderPool.h
+    Part of WavemorpherSynthesizer project
+
+    Created: 17th October 2026
+    Author:  agent
+
+    Description: A fixed pool of real time worker threads that help the
+    audio thread get through a batch of jobs, such as rendering the voices
+    playing. The jobs are split into one contiguous range per thread, each
+    thread takes jobs from the front of its own range and, once that runs
+    out, steals from the back of the others' ranges. Taking and stealing
+    are a single compare and swap, and the workers are woken through a
+    semaphore that only makes a system call when a worker is asleep, so
+    the audio thread never locks. It works through the jobs itself as well,
+    so a worker that is slow to wake up just has its jobs stolen rather
+    than holding up the block, and the only wait is for jobs a worker is
+    already in the middle of. The workers are started and stopped from the
+    message thread, and a batch run while none are running is handed back
+    to the caller to run itself.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "WakeSignal.h"
+
+/*!
+ @class VoiceRenderPool
+ @abstract lock-free work-stealing thread pool for running a batch of jobs from the audio thread
+ @discussion the threads sleep between batches, run() returns once every job has run
+
+ @namespace none
+ */
+class VoiceRenderPool
+{
+public:
+    /// Most worker threads the pool will start, whatever the number of cores
+    static constexpr int maxWorkers = 15;
+
+    /*!
+     @class Jobs
+     @abstract a batch of jobs for the pool to run, identified by their index in the batch
+     */
+    class Jobs
+    {
+    public:
+        virtual ~Jobs() = default;
+
+        /**
+         Run one job of the batch, may be called from any of the pool's threads or the audio thread
+
+         @param index of the job in the batch
+         @param index of the thread running it, 0 is the thread that called run() and the workers are 1 upwards
+         */
+        virtual void runJob(int job, int participant) noexcept = 0;
+    };
+
+    VoiceRenderPool() = default;
+    ~VoiceRenderPool();
+
+    //--------------------------------------------------------------------------
+    /**
+     Start the worker threads, not to be called from the audio thread
+
+     Safe to call while the audio thread is running batches, they carry on without workers until they have started
+
+     @param number of worker threads to start, on top of the thread calling run()
+     */
+    void start(int numWorkersToStart);
+
+    //--------------------------------------------------------------------------
+    /**
+     Stop and delete the worker threads, not to be called from the audio thread
+
+     Waits for any batch the audio thread is running to finish first
+     */
+    void stop();
+
+    //--------------------------------------------------------------------------
+    /**
+     Are the worker threads running
+     */
+    bool isRunning() const noexcept;
+
+    //--------------------------------------------------------------------------
+    /**
+     Run every job of a batch, spread across the worker threads and the calling thread
+
+     Returns once every job has finished. Which thread runs which job changes
+     from batch to batch, so jobs must not depend on each other or on the order they run in
+
+     @param batch of jobs to run
+     @param number of jobs in the batch
+     @return false without running any job if the workers aren't running, for the caller to run them itself
+     */
+    bool run(Jobs& jobs, int numJobs) noexcept;
+
+private:
+    //--------------------------------------------------------------------------
+    /*!
+     @class Worker
+     @abstract real time thread that sleeps until a batch is started, then helps run it
+     */
+    class Worker : public juce::Thread
+    {
+    public:
+        Worker(VoiceRenderPool& _pool, int _participant);
+
+        /// Wake the worker up to help with a new batch
+        void wake() noexcept;
+
+        void run() override;
+
+    private:
+        VoiceRenderPool& pool;
+
+        /// Index of the worker among the pool's participants
+        const int participant;
+
+        /// Signalled when a batch starts, or when the thread should exit
+        WakeSignal batchStarted;
+    };
+
+    //--------------------------------------------------------------------------
+    /// Run jobs until there are none left to take or steal
+    void work(int participant) noexcept;
+
+    /// Take the next job from the front of a participant's own range, returns -1 if it is empty
+    int takeJob(int participant) noexcept;
+
+    /// Steal the last job from the back of another participant's range, returns -1 if it is empty
+    int stealJob(int victim) noexcept;
+
+    /// Pack the first job and one past the last job of a range into one atomic word
+    static juce::uint64 packRange(juce::uint32 begin, juce::uint32 end) noexcept
+    {
+        return (juce::uint64)begin | ((juce::uint64)end << 32);
+    }
+
+    //--------------------------------------------------------------------------
+    /// The worker threads
+    juce::OwnedArray<Worker> workers;
+
+    /// Batch being run, published to the workers before the ranges
+    std::atomic<Jobs*> currentJobs { nullptr };
+
+    /// Range of jobs still to run for each participant, begin in the low 32 bits and end in the high 32 bits
+    std::atomic<juce::uint64> ranges[maxWorkers + 1];
+
+    /// Number of jobs of the current batch that have finished
+    std::atomic<int> jobsFinished { 0 };
+
+    /// Number of participants the current batch was split between
+    std::atomic<int> numParticipants { 1 };
+
+    /// Set while the workers are running, and while the audio thread is inside run(), stop() waits for the one
+    /// after clearing the other, and run() checks the other after setting the one, so they never overlap
+    std::atomic<bool> workersRunning { false };
+    std::atomic<bool> batchRunning { false };
+};
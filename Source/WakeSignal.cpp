@@ -0,0 +1,97 @@
+/*
+  ==============================================================================
+
+    WakeSignal.cpp
+    Part of WavemorpherSynthesizer project
+
+    Created: 17th October 2026
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#include "WakeSignal.h"
+
+#if JUCE_WINDOWS
+ #ifndef NOMINMAX
+  #define NOMINMAX
+ #endif
+ #include <windows.h>
+#elif JUCE_MAC || JUCE_IOS
+ #include <dispatch/dispatch.h>
+#else
+ #include <semaphore.h>
+ #include <cerrno>
+#endif
+
+#if JUCE_WINDOWS
+struct WakeSignal::NativeSemaphore
+{
+    NativeSemaphore() : handle(CreateSemaphoreW(nullptr, 0, 1 << 30, nullptr)) {}
+    ~NativeSemaphore() { CloseHandle(handle); }
+
+    void post() noexcept { ReleaseSemaphore(handle, 1, nullptr); }
+    void wait() noexcept { WaitForSingleObject(handle, INFINITE); }
+
+    HANDLE handle;
+};
+#elif JUCE_MAC || JUCE_IOS
+struct WakeSignal::NativeSemaphore
+{
+    NativeSemaphore() : handle(dispatch_semaphore_create(0)) {}
+    ~NativeSemaphore() { dispatch_release(handle); }
+
+    void post() noexcept { dispatch_semaphore_signal(handle); }
+    void wait() noexcept { dispatch_semaphore_wait(handle, DISPATCH_TIME_FOREVER); }
+
+    dispatch_semaphore_t handle;
+};
+#else
+struct WakeSignal::NativeSemaphore
+{
+    NativeSemaphore() { sem_init(&handle, 0, 0); }
+    ~NativeSemaphore() { sem_destroy(&handle); }
+
+    void post() noexcept { sem_post(&handle); }
+
+    void wait() noexcept
+    {
+        // a signal handler interrupting the wait isn't a wake up
+        while (sem_wait(&handle) != 0 && errno == EINTR) {}
+    }
+
+    sem_t handle;
+};
+#endif
+
+WakeSignal::WakeSignal()
+    : semaphore(std::make_unique<NativeSemaphore>())
+{
+}
+
+WakeSignal::~WakeSignal() = default;
+
+void WakeSignal::signal() noexcept
+{
+    auto current = count.load(std::memory_order_relaxed);
+
+    // already signalled, or bump the count, waking the thread if it was asleep
+    for (;;)
+    {
+        if (current >= 1)
+            return;
+
+        if (count.compare_exchange_weak(current, current + 1, std::memory_order_release, std::memory_order_relaxed))
+            break;
+    }
+
+    if (current < 0)
+        semaphore->post();
+}
+
+void WakeSignal::wait() noexcept
+{
+    // from signalled straight back to not, or from not to asleep until signal posts the semaphore
+    if (count.fetch_sub(1, std::memory_order_acquire) < 1)
+        semaphore->wait();
+}
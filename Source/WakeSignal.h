@@ -0,0 +1,58 @@
+/*
+  ==============================================================================
+
+    WakeSignal.h
+    Part of WavemorpherSynthesizer project
+
+    Created: 17th October 2026
+    Author:  agent
+
+    Description: Auto reset event for the audio thread to wake a helper
+    thread with, such as the voice render workers or the effects thread.
+    Unlike juce::WaitableEvent, signalling it never takes a lock: it is a
+    single atomic count of 1 when signalled, 0 when not and -1 while the
+    thread is asleep, and the platform's semaphore is only posted when the
+    count shows there is a thread asleep on it.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/*!
+ @class WakeSignal
+ @abstract auto reset event whose signal never locks
+ @discussion for one thread to wait on, any number of threads can signal it
+
+ @namespace none
+ */
+class WakeSignal
+{
+public:
+    WakeSignal();
+    ~WakeSignal();
+
+    //--------------------------------------------------------------------------
+    /**
+     Wake the waiting thread, or let its next wait return straight away, safe on the audio thread
+     */
+    void signal() noexcept;
+
+    //--------------------------------------------------------------------------
+    /**
+     Sleep until signalled, returning straight away if already signalled
+     */
+    void wait() noexcept;
+
+private:
+    /// 1 if signalled, 0 if not, -1 while the thread is asleep
+    std::atomic<int> count { 0 };
+
+    /// The platform's semaphore, only used once the count shows a thread has to sleep
+    struct NativeSemaphore;
+    std::unique_ptr<NativeSemaphore> semaphore;
+
+    JUCE_DECLARE_NON_COPYABLE(WakeSignal)
+};
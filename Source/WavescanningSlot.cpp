@@ -52,58 +52,51 @@ void WavescanningSlot::setWavetable(const void* data, size_t dataSize)
     }
 
 
-    // set cutoff frequency, single value for now. will make an array
-    double cutoff[numWavetableOctaves] = { 16000.0, 16000.0, 16000.0, 16000.0, 10000.0, 1000.0, 50.0, 10.0, 8.0, 8.0 };
+    // nothing decoded, leave the octaves as they were
+    if (wtFileBuffer.getNumSamples() < 2)
+        return;
 
-    // find the range of values for the unfiltered buffer
-    juce::Range<float> preRange = wtFileBuffer.findMinMax(0, 0, wtFileBuffer.getNumSamples());
+    setWavetableCycle(wtFileBuffer.getReadPointer(0), wtFileBuffer.getNumSamples());
+}
+
+void WavescanningSlot::setWavetableCycle(const float* cycle, int cycleLength)
+{
+    // band limit one cycle into ten wavetables across the midi note range, each keeping only the harmonics its notes can play without aliasing
+    juce::AudioBuffer<float> octaves[numWavetableOctaves];
 
-    // absolute max value before filtering
-    float preMaxVal = abs(std::max(preRange.getStart(), preRange.getEnd()));
+    MipmapBuilder mipmapBuilder(SR);
+    mipmapBuilder.build(cycle, cycleLength, octaves, numWavetableOctaves);
 
-    // from the original buffer creating ten wavetable across the midi note range with varying levels of filtering
     for (int wtNumber = 0; wtNumber < numWavetableOctaves; wtNumber++)
     {
-        // initialize filter with coefficients
-        mWavescanner[wtNumber].wtFilter.setCoefficients(juce::IIRCoefficients::makeLowPass(SR, cutoff[wtNumber], 1.0));
-
-        // reset filter
-        mWavescanner[wtNumber].wtFilter.reset();
-
-        // store the wavetable length
-        mWavescanner[wtNumber].wavetableLength = wtFileBuffer.getNumSamples();
-
-        // copy the wt buffer into the structure
-        mWavescanner[wtNumber].antialiasedWavetable = wtFileBuffer;
-
-        // process wavetables with the filter
-        for (int channel = 0; channel < wtFileBuffer.getNumChannels(); channel++)
-        {
-            mWavescanner[wtNumber].wtFilter.processSamples(mWavescanner[wtNumber].antialiasedWavetable.getWritePointer(channel), mWavescanner[wtNumber].wavetableLength);
-
-
-            // find the range of values for the filtered buffer
-            juce::Range<float> postRange = mWavescanner[wtNumber].antialiasedWavetable.findMinMax(0, 0, wtFileBuffer.getNumSamples());
-
-            //find the absolute max value after filtering
-            float postMaxVal = abs(std::max(postRange.getStart(), postRange.getEnd()));
-
-            // create pointer
-            float* channelSamp = mWavescanner[wtNumber].antialiasedWavetable.getWritePointer(channel);
+        // store the wavetable length, not counting the guard samples on the end
+        mWavescanner[wtNumber].wavetableLength = octaves[wtNumber].getNumSamples() - WavetableOscillator::numGuardSamples;
+        // moved rather than copied, so a slot that was referring to octaves elsewhere never writes into them
+        mWavescanner[wtNumber].antialiasedWavetable = std::move(octaves[wtNumber]);
+    }
+}
 
-            //normalizing volume across wavetable
-            for (int sample = 0; sample < mWavescanner[wtNumber].wavetableLength; sample++)
-            {
-                channelSamp[sample] *= preMaxVal / postMaxVal;
-            }
+void WavescanningSlot::setPrecomputedWavetable(const FactoryMipmaps::Pyramid& pyramid)
+{
+    static_assert(FactoryMipmaps::numOctaves == numWavetableOctaves, "the factory mipmaps need generating with the same number of octaves");
+    jassert(pyramid.sampleRate == SR);
 
-        }
+    referToOctaves(pyramid.octaves, pyramid.octaveLengths);
+}
 
+void WavescanningSlot::referToOctaves(const float* const* octaves, const int* octaveLengths)
+{
+    for (int wtNumber = 0; wtNumber < numWavetableOctaves; wtNumber++)
+    {
+        // the octaves are only ever read, the slot hands its buffers out as const
+        float* channels[] = { const_cast<float*>(octaves[wtNumber]) };
 
+        mWavescanner[wtNumber].wavetableLength = octaveLengths[wtNumber];
+        mWavescanner[wtNumber].antialiasedWavetable.setDataToReferTo(channels, 1, octaveLengths[wtNumber] + WavetableOscillator::numGuardSamples);
     }
 }
 
-juce::AudioBuffer<float> WavescanningSlot::getAntialiasedWavetable(int octaveNumber)
+const juce::AudioBuffer<float>& WavescanningSlot::getAntialiasedWavetable(int octaveNumber) const
 {
     return mWavescanner[octaveNumber].antialiasedWavetable;
 }
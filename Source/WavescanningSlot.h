@@ -14,10 +14,16 @@
 
 #include <JuceHeader.h>
 #include <BinaryData.h>
+#include "WavetableOscillator.h"
+#include "MipmapBuilder.h"
+#include "FactoryMipmaps.h"
 
 class WavescanningSlot
 {
 public:
+    /// Number of antialiased octaves built from each wavetable
+    static constexpr int numWavetableOctaves = 10;
+
     WavescanningSlot(double sampleRate);
 
 
@@ -25,18 +31,51 @@ public:
     /**
      Create wavetable from binary data and storing as a juce audio buffer "named wtFileBuffer"
 
-    Subsequently calls the antialiasing function below to deal with the artifacting issues
+    Subsequently builds the band limited octaves from its first channel with the MipmapBuilder
      */
     void setWavetable(const void* _data, size_t _dataSize);
 
+    //--------------------------------------------------------------------------
+    /**
+     Use octaves generated ahead of time instead of building them
+
+     The octaves are referred to rather than copied, so the pyramid has to outlive the slot
+
+     @param pyramid of octaves built for this slot's sample rate
+     */
+    void setPrecomputedWavetable(const FactoryMipmaps::Pyramid& pyramid);
+
+    //--------------------------------------------------------------------------
+    /**
+     Build the band limited octaves from a single cycle with the MipmapBuilder
+
+     @param samples of one cycle
+     @param number of samples in the cycle
+     */
+    void setWavetableCycle(const float* cycle, int cycleLength);
+
+    //--------------------------------------------------------------------------
+    /**
+     Use octaves that have already been built somewhere else, such as a mapped library
+
+     The octaves are referred to rather than copied, so they have to outlive the slot
+
+     @param samples of each octave, with WavetableOscillator::numGuardSamples repeats of the start on the end
+     @param length of each octave, not counting the guard samples
+     */
+    void referToOctaves(const float* const* octaves, const int* octaveLengths);
+
     //--------------------------------------------------------------------------
     /**
      Get the juce audio buffer of the wavetable at the chosen octave
 
+     The buffer has WavetableOscillator::numGuardSamples extra samples on the end
+     that repeat the start of the wavetable
+
      @param current octave for which the wavetable is to be used
     
      */
-    juce::AudioBuffer<float> getAntialiasedWavetable(int octaveNumber);
+    const juce::AudioBuffer<float>& getAntialiasedWavetable(int octaveNumber) const;
 
 
 private:
@@ -51,9 +90,7 @@ private:
     struct wavetableOctaves {
         int wavetableLength;
         juce::AudioBuffer<float> antialiasedWavetable;
-        juce::IIRFilter wtFilter;   // filter for reducing aliasing of wavetables
     };
-    static constexpr int numWavetableOctaves = 10;
     wavetableOctaves mWavescanner[numWavetableOctaves];
 
     /// Storing sample rate
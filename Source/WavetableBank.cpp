@@ -0,0 +1,156 @@
+/*
+  ==============================================================================
+
+    WavetableBank.cpp
+    Part of WavemorpherSynthesizer project
+
+    Created: 17th October 2026
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#include "WavetableBank.h"
+
+/// Find the generated octaves of a factory wavetable at a sample rate, null if there aren't any
+static const FactoryMipmaps::Pyramid* findFactoryMipmaps(const char* resourceName, double sampleRate)
+{
+    for (int index = 0; index < FactoryMipmaps::numPyramids; index++)
+    {
+        const auto& pyramid = FactoryMipmaps::pyramids[index];
+
+        if (pyramid.sampleRate == sampleRate && std::strcmp(pyramid.resourceName, resourceName) == 0)
+            return &pyramid;
+    }
+
+    return nullptr;
+}
+
+WavetableBank::WavetableBank(double sampleRate, WavetableLibrary::Ptr libraryToUse)
+    : library(libraryToUse)
+{
+    // setting sample rate for later use
+    SR = sampleRate;
+
+    for (int index = 0; index < BinaryData::namedResourceListSize; index++)
+    {
+        // get the data name using this index
+        const char* namedResource = BinaryData::namedResourceList[index];
+
+        // create data size variable
+        int dataSize;
+
+        // using the get named resource function to set the dataSize variable to the size of the data in bytes
+        const char* data = BinaryData::getNamedResource(namedResource, dataSize);
+
+        auto* wavetable = wavetables.add(new WavescanningSlot(SR));
+
+        // at the common sample rates the octaves were built when the plugin was, so there is nothing to decode or transform
+        if (auto* pyramid = findFactoryMipmaps(namedResource, SR))
+        {
+            wavetable->setPrecomputedWavetable(*pyramid);
+            continue;
+        }
+
+        // decode and antialias the wavetable once, every voice will read from this copy
+        wavetable->setWavetable(data, dataSize);
+    }
+
+    // library tables are left empty until something plays them
+    if (library != nullptr)
+        for (int table = 0; table < library->getNumTables(); table++)
+            wavetables.add(nullptr);
+}
+
+int WavetableBank::getNumWavetables() const
+{
+    return wavetables.size();
+}
+
+const WavescanningSlot& WavetableBank::getWavetable(int index)
+{
+    jassert(juce::isPositiveAndBelow(index, wavetables.size()));
+
+    if (auto* wavetable = wavetables.getUnchecked(index))
+        return *wavetable;
+
+    auto* wavetable = new WavescanningSlot(SR);
+    loadLibraryTable(*wavetable, index - BinaryData::namedResourceListSize);
+    wavetables.set(index, wavetable);
+
+    return *wavetable;
+}
+
+void WavetableBank::loadLibraryTable(WavescanningSlot& wavetable, int table) const
+{
+    // at the library's sample rate or above its octaves can't alias, so they're played straight from the mapped file
+    if (SR >= library->getSampleRate())
+    {
+        const float* octaves[WavescanningSlot::numWavetableOctaves];
+        int octaveLengths[WavescanningSlot::numWavetableOctaves];
+
+        for (int octave = 0; octave < WavescanningSlot::numWavetableOctaves; octave++)
+            octaves[octave] = library->getOctave(table, octave, octaveLengths[octave]);
+
+        wavetable.referToOctaves(octaves, octaveLengths);
+        return;
+    }
+
+    // below it they would keep harmonics that fold back, so band limit the raw cycle again for this rate
+    int cycleLength;
+    const float* cycle = library->getCycle(table, cycleLength);
+
+    wavetable.setWavetableCycle(cycle, cycleLength);
+}
+
+int WavetableBank::getNumWavetables(const WavetableLibrary* library)
+{
+    return BinaryData::namedResourceListSize + (library != nullptr ? library->getNumTables() : 0);
+}
+
+int WavetableBank::getMaxNumWavetables()
+{
+    return getFirstImportedIndex() + maxImportedWavetables;
+}
+
+int WavetableBank::getFirstImportedIndex()
+{
+    return BinaryData::namedResourceListSize + WavetableLibrary::maxTables;
+}
+
+int WavetableBank::getNumUserTables()
+{
+    return WavetableLibrary::maxTables + maxImportedWavetables;
+}
+
+int WavetableBank::getWavetableIndex(int factoryTable, int userTable)
+{
+    return userTable > 0 ? BinaryData::namedResourceListSize + userTable - 1 : factoryTable;
+}
+
+int WavetableBank::getUserTable(int index)
+{
+    return index >= BinaryData::namedResourceListSize ? index - BinaryData::namedResourceListSize + 1 : 0;
+}
+
+juce::StringArray WavetableBank::getWavetableNames(const WavetableLibrary* library, const juce::StringArray& importedNames)
+{
+    juce::StringArray names;
+    names.ensureStorageAllocated(getMaxNumWavetables());
+
+    for (int index = 0; index < BinaryData::namedResourceListSize; index++)
+        names.add(BinaryData::originalFilenames[index]);
+
+    for (int table = 0; table < WavetableLibrary::maxTables; table++)
+        names.add(library != nullptr && table < library->getNumTables() ? library->getName(table) : juce::String());
+
+    for (int table = 0; table < maxImportedWavetables; table++)
+        names.add(importedNames[table]);
+
+    return names;
+}
+
+double WavetableBank::getSampleRate() const
+{
+    return SR;
+}
@@ -0,0 +1,157 @@
+/*
+  ==============================================================================
+
+    WavetableBank.h
+    Part of WavemorpherSynthesizer project
+
+    Created: 17th October 2026
+    Author:  agent
+
+    Description: Single read-only store of every wavetable in BinaryData along
+    with its antialiased octaves. Owned by the processor and shared between
+    all of the synthesiser voices, so each table is only decoded and filtered
+    once regardless of how many voices or slots are using it. At the sample
+    rates in FactoryMipmaps the octaves are taken from the generated data
+    instead, and building the bank costs next to nothing.
+
+    The tables of a WavetableLibrary, if one is open, follow the factory
+    tables. They are only set up the first time a slot picks them, pointing
+    straight at the library's mapped octaves, so a library of tens of
+    thousands of tables costs nothing until they are played. Room is left
+    for a full library whatever is open, so an index always means the same
+    position and saved automation isn't moved about by the library changing.
+
+    The indices after the library's are for wavetables imported from disk.
+    The bank doesn't hold those, the WavetableBuilder does, but they are
+    numbered here so that every table a slot can pick has its own index.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <BinaryData.h>
+#include "WavescanningSlot.h"
+#include "WavetableLibrary.h"
+
+/*!
+ @class WavetableBank
+ @abstract reference counted collection of antialiased wavetables
+ @discussion built once per sample rate, voices only ever read from it
+
+ @namespace none
+ */
+class WavetableBank : public juce::ReferenceCountedObject
+{
+public:
+    using Ptr = juce::ReferenceCountedObjectPtr<WavetableBank>;
+
+    //--------------------------------------------------------------------------
+    /**
+     Decode and antialias every wavetable found in BinaryData
+
+     @param sample rate the antialiasing filters are designed for
+     @param library whose tables follow the factory ones, may be null
+     */
+    WavetableBank(double sampleRate, WavetableLibrary::Ptr library);
+
+    //--------------------------------------------------------------------------
+    /**
+     Get the number of wavetables stored in the bank
+     */
+    int getNumWavetables() const;
+
+    //--------------------------------------------------------------------------
+    /**
+     Get a wavetable from the bank, setting it up first if it is a library table that hasn't been used yet
+
+     Only called while building tables, never from the audio thread
+
+     @param index of the wavetable, the factory tables in BinaryData order followed by the library's
+     */
+    const WavescanningSlot& getWavetable(int index);
+
+    //--------------------------------------------------------------------------
+    /**
+     Get the number of wavetables a bank built with a library would hold
+
+     @param library whose tables follow the factory ones, may be null
+     */
+    static int getNumWavetables(const WavetableLibrary* library);
+
+    //--------------------------------------------------------------------------
+    /**
+     Get the number of wavetable indices, the factory tables, a full library and the imported tables
+
+     Indices the bank has no table for and imported ones with nothing imported yet are valid parameter
+     values with no table behind them
+     */
+    static int getMaxNumWavetables();
+
+    //--------------------------------------------------------------------------
+    /**
+     Get the index of the first imported wavetable, the rest follow it
+     */
+    static int getFirstImportedIndex();
+
+    /// Most wavetables imported at once, one for each wavescanning slot
+    static constexpr int maxImportedWavetables = 5;
+
+    //--------------------------------------------------------------------------
+    /**
+     Get the number of user tables, the library's followed by the imported ones
+
+     A slot's user table parameter goes from zero, for the factory table its wavetype picks,
+     to this, so the wavetype parameters keep the range of the factory tables
+     */
+    static int getNumUserTables();
+
+    //--------------------------------------------------------------------------
+    /**
+     Get the wavetable index a slot plays
+
+     @param factory table the slot's wavetype picks
+     @param user table the slot's user table parameter picks, zero for none
+     */
+    static int getWavetableIndex(int factoryTable, int userTable);
+
+    //--------------------------------------------------------------------------
+    /**
+     Get the user table parameter value that picks a wavetable index, zero for a factory table
+
+     @param wavetable index
+     */
+    static int getUserTable(int index);
+
+    //--------------------------------------------------------------------------
+    /**
+     Get the name of every wavetable index, empty for those with no table behind them
+
+     @param library whose tables follow the factory ones, may be null
+     @param names of the imported wavetables, in order
+     @return getMaxNumWavetables names
+     */
+    static juce::StringArray getWavetableNames(const WavetableLibrary* library, const juce::StringArray& importedNames);
+
+    //--------------------------------------------------------------------------
+    /**
+     Get the sample rate the bank was built for
+     */
+    double getSampleRate() const;
+
+private:
+    /// Point a slot at a library table's octaves, or rebuild them from its cycle below the library's sample rate
+    void loadLibraryTable(WavescanningSlot& wavetable, int table) const;
+
+    /// One entry per wavetable in BinaryData, in the same order as namedResourceList, then one per library table, null until it is used
+    juce::OwnedArray<WavescanningSlot> wavetables;
+
+    /// Library the later tables come from, held so its mapping outlives every slot reading from it
+    WavetableLibrary::Ptr library;
+
+    /// Storing sample rate
+    double SR;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WavetableBank)
+};
@@ -0,0 +1,325 @@
+/*
+  ==============================================================================
+
+    WavetableBuilder.cpp
+    Part of WavemorpherSynthesizer project
+
+    Created: 17th October 2026
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#include "WavetableBuilder.h"
+
+UserWavetable::UserWavetable(const juce::String& wavetableName, const juce::AudioBuffer<float>& wavetableCycle, double wavetableSampleRate)
+    : name(wavetableName),
+    cycle(wavetableCycle),
+    sampleRate(wavetableSampleRate),
+    wavetable(wavetableSampleRate)
+{
+    wavetable.setWavetableCycle(cycle.getReadPointer(0), cycle.getNumSamples());
+}
+
+WavetableBuilder::WavetableBuilder(juce::AudioProcessorValueTreeState& parametersToWatch, WavetableLibrary::Ptr libraryToUse)
+    : juce::Thread("Wavetable Builder"),
+    parameters(parametersToWatch),
+    library(libraryToUse)
+{
+    // check for retired tables that can be freed a couple of times a second
+    startTimer(500);
+}
+
+WavetableBuilder::~WavetableBuilder()
+{
+    stopTimer();
+    stopThread(2000);
+}
+
+void WavetableBuilder::prepare(double sampleRate)
+{
+    requestedSampleRate = sampleRate;
+
+    // look up the slot parameters once, before the builder thread first reads them
+    if (!isThreadRunning())
+    {
+        for (int slot = 0; slot < WavescanTables::numSlots; slot++)
+        {
+            slotParameters[slot] = parameters.getRawParameterValue(slotParameterIDs[slot]);
+            userTableParameters[slot] = parameters.getRawParameterValue(userTableParameterIDs[slot]);
+        }
+
+        wavescanParameter = parameters.getRawParameterValue("wavescan");
+        lfoAmpParameter = parameters.getRawParameterValue("lfo_amp");
+    }
+
+    // make sure there is always something to play before processing begins
+    if (currentTables.load() == nullptr)
+    {
+        const juce::ScopedLock sl(buildLock);
+        rebuildIfNeeded();
+    }
+
+    if (!isThreadRunning())
+        startThread();
+}
+
+WavescanTables* WavetableBuilder::getCurrentTables() const noexcept
+{
+    return currentTables.load(std::memory_order_acquire);
+}
+
+MorphTable* WavetableBuilder::getCurrentMorphTable() const noexcept
+{
+    return currentMorphTable.load(std::memory_order_acquire);
+}
+
+int WavetableBuilder::addImportedWavetables(const juce::ReferenceCountedArray<UserWavetable>& wavetables)
+{
+    const juce::ScopedLock sl(importedWavetableLock);
+
+    int numAdded = 0;
+
+    // empty indices first, then ones holding an earlier import that no slot is playing
+    for (int pass = 0; pass < 2; pass++)
+    {
+        for (int i = 0; i < WavetableBank::maxImportedWavetables && numAdded < wavetables.size(); i++)
+        {
+            const bool empty = importedWavetables[i] == nullptr;
+
+            if (empty != (pass == 0) || !isImportedIndexFree(i))
+                continue;
+
+            importedWavetables[i] = wavetables[numAdded++];
+        }
+    }
+
+    numImports++;
+    return numAdded;
+}
+
+int WavetableBuilder::getNumFreeImportedIndices() const
+{
+    int numFree = 0;
+
+    for (int i = 0; i < WavetableBank::maxImportedWavetables; i++)
+        if (isImportedIndexFree(i))
+            numFree++;
+
+    return numFree;
+}
+
+juce::StringArray WavetableBuilder::getImportedWavetableNames() const
+{
+    const juce::ScopedLock sl(importedWavetableLock);
+
+    juce::StringArray names;
+
+    for (auto& wavetable : importedWavetables)
+        names.add(wavetable != nullptr ? wavetable->name : juce::String());
+
+    return names;
+}
+
+juce::uint32 WavetableBuilder::getNumImports() const
+{
+    const juce::ScopedLock sl(importedWavetableLock);
+    return numImports;
+}
+
+double WavetableBuilder::getSampleRate() const noexcept
+{
+    return requestedSampleRate.load();
+}
+
+void WavetableBuilder::audioBlockFinished() noexcept
+{
+    audioBlockCount.fetch_add(1, std::memory_order_release);
+}
+
+void WavetableBuilder::run()
+{
+    while (!threadShouldExit())
+    {
+        // the audio thread never signals this thread, the slot parameters are polled instead
+        wait(20);
+
+        const juce::ScopedLock sl(buildLock);
+        rebuildIfNeeded();
+        rebakeIfNeeded();
+    }
+}
+
+void WavetableBuilder::rebuildIfNeeded()
+{
+    const double sampleRate = requestedSampleRate.load();
+
+    if (sampleRate <= 0.0)
+        return;
+
+    // the imported wavetables, with their octaves built again if the sample rate has changed since they were built
+    UserWavetable::Ptr imported[WavetableBank::maxImportedWavetables];
+
+    {
+        const juce::ScopedLock sl(importedWavetableLock);
+
+        for (int i = 0; i < WavetableBank::maxImportedWavetables; i++)
+        {
+            auto& wavetable = importedWavetables[i];
+
+            if (wavetable != nullptr && wavetable->sampleRate != sampleRate)
+                wavetable = new UserWavetable(wavetable->name, wavetable->cycle, sampleRate);
+
+            imported[i] = wavetable;
+        }
+    }
+
+    // find which wavetable each slot should now be using
+    int indices[WavescanTables::numSlots];
+    UserWavetable::Ptr userWavetables[WavescanTables::numSlots];
+    const int numWavetables = WavetableBank::getNumWavetables(library.get());
+
+    for (int slot = 0; slot < WavescanTables::numSlots; slot++)
+    {
+        const int index = getSlotIndex(slot);
+        const int importedIndex = index - WavetableBank::getFirstImportedIndex();
+
+        // an index with no table behind it, past the end of the library or with nothing imported, plays the first table instead
+        if (juce::isPositiveAndBelow(importedIndex, WavetableBank::maxImportedWavetables))
+            userWavetables[slot] = imported[importedIndex];
+
+        indices[slot] = userWavetables[slot] != nullptr || juce::isPositiveAndBelow(index, numWavetables) ? index : 0;
+    }
+
+    // nothing to do if the published tables already match
+    bool bankNeedsBuilding = liveTables == nullptr || liveTables->bank->getSampleRate() != sampleRate;
+    bool slotsChanged = bankNeedsBuilding;
+
+    for (int slot = 0; slot < WavescanTables::numSlots && !slotsChanged; slot++)
+        slotsChanged = liveTables->indices[slot] != indices[slot] || liveTables->userWavetables[slot].get() != userWavetables[slot].get();
+
+    if (!slotsChanged)
+        return;
+
+    // decoding and antialiasing only happens here, never on the audio thread
+    WavescanTables::Ptr newTables = new WavescanTables();
+    newTables->bank = bankNeedsBuilding ? WavetableBank::Ptr(new WavetableBank(sampleRate, library)) : liveTables->bank;
+
+    for (int slot = 0; slot < WavescanTables::numSlots; slot++)
+    {
+        newTables->indices[slot] = indices[slot];
+        newTables->userWavetables[slot] = userWavetables[slot];
+        newTables->slots[slot] = userWavetables[slot] != nullptr ? &userWavetables[slot]->wavetable
+                                                                 : &newTables->bank->getWavetable(indices[slot]);
+    }
+
+    // publish the new tables, the audio thread picks them up on its next block
+    auto oldTables = liveTables;
+    liveTables = newTables;
+    currentTables.store(newTables.get(), std::memory_order_release);
+
+    // the audio thread may still be reading the old tables, so hold on to them until it can't be
+    if (oldTables != nullptr)
+        retire(oldTables, nullptr);
+}
+
+int WavetableBuilder::getSlotIndex(int slot) const
+{
+    if (slotParameters[slot] == nullptr || userTableParameters[slot] == nullptr)
+        return -1;
+
+    return WavetableBank::getWavetableIndex(juce::roundToInt(slotParameters[slot]->load()), juce::roundToInt(userTableParameters[slot]->load()));
+}
+
+bool WavetableBuilder::isImportedIndexFree(int importedIndex) const
+{
+    for (int slot = 0; slot < WavescanTables::numSlots; slot++)
+        if (getSlotIndex(slot) == WavetableBank::getFirstImportedIndex() + importedIndex)
+            return false;
+
+    return true;
+}
+
+void WavetableBuilder::rebakeIfNeeded()
+{
+    const float wavescanPosition = juce::jlimit(0.0f, 4.0f, wavescanParameter->load());
+    const bool positionSettled = wavescanPosition == lastWavescanPosition;
+    lastWavescanPosition = wavescanPosition;
+
+    // a morph table made from tables that have since been replaced can never be played again
+    if (liveMorphTable != nullptr && liveMorphTable->tables != liveTables.get())
+        publishMorphTable(nullptr);
+
+    // voices only play a morph table while the lfo isn't moving the wavescan position
+    if (!positionSettled || *lfoAmpParameter != 0.0f || liveTables == nullptr)
+        return;
+
+    if (liveMorphTable != nullptr && liveMorphTable->tables == liveTables.get() && liveMorphTable->wavescanPosition == wavescanPosition)
+        return;
+
+    // the same pair of slots and blend amount the voice would use when morphing live
+    const int lowerSlot = juce::jlimit(0, WavescanTables::numSlots - 2, (int)wavescanPosition);
+    const float blend = wavescanPosition - (float)lowerSlot;
+
+    const auto* lowerWavetable = liveTables->slots[lowerSlot];
+    const auto* upperWavetable = liveTables->slots[lowerSlot + 1];
+
+    MorphTable::Ptr newMorphTable = new MorphTable();
+    newMorphTable->tables = liveTables;
+    newMorphTable->wavescanPosition = wavescanPosition;
+
+    for (int octave = 0; octave < WavescanningSlot::numWavetableOctaves; octave++)
+    {
+        const auto& lowerOctave = lowerWavetable->getAntialiasedWavetable(octave);
+        const auto& upperOctave = upperWavetable->getAntialiasedWavetable(octave);
+
+        // tables of different lengths can't be blended sample by sample, so they are always morphed live
+        if (lowerOctave.getNumSamples() != upperOctave.getNumSamples())
+            return;
+
+        // the spline is linear in the samples, so interpolating the blend is the same as blending the interpolations
+        auto& octaveBuffer = newMorphTable->octaves[octave];
+        octaveBuffer.setSize(1, lowerOctave.getNumSamples());
+        juce::FloatVectorOperations::copyWithMultiply(octaveBuffer.getWritePointer(0), lowerOctave.getReadPointer(0), 1.0f - blend, lowerOctave.getNumSamples());
+        juce::FloatVectorOperations::addWithMultiply(octaveBuffer.getWritePointer(0), upperOctave.getReadPointer(0), blend, lowerOctave.getNumSamples());
+    }
+
+    publishMorphTable(newMorphTable);
+}
+
+void WavetableBuilder::publishMorphTable(MorphTable::Ptr newMorphTable)
+{
+    // publish the new morph table, retiring the old one just like the tables
+    auto oldMorphTable = liveMorphTable;
+    liveMorphTable = newMorphTable;
+    currentMorphTable.store(newMorphTable.get(), std::memory_order_release);
+
+    if (oldMorphTable != nullptr)
+        retire(nullptr, oldMorphTable);
+}
+
+void WavetableBuilder::retire(WavescanTables::Ptr tables, MorphTable::Ptr morphTable)
+{
+    const juce::ScopedLock sl(retiredLock);
+    retiredTables.add({ tables, morphTable, audioBlockCount.load(std::memory_order_acquire) });
+}
+
+void WavetableBuilder::timerCallback()
+{
+    const juce::ScopedLock sl(retiredLock);
+
+    const auto blocksFinished = audioBlockCount.load(std::memory_order_acquire);
+
+    for (int i = retiredTables.size(); --i >= 0;)
+    {
+        auto& retired = retiredTables.getReference(i);
+
+        const juce::ReferenceCountedObject* object = retired.tables != nullptr ? (juce::ReferenceCountedObject*)retired.tables.get()
+                                                                               : (juce::ReferenceCountedObject*)retired.morphTable.get();
+
+        // a block that started after the swap has finished, so no block can still be holding the raw pointer,
+        // and a reference count of one means no voice is still crossfading out of or playing these tables
+        if (blocksFinished - retired.retiredAtBlock >= 2 && object->getReferenceCount() == 1)
+            retiredTables.remove(i);
+    }
+}
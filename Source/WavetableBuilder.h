@@ -0,0 +1,302 @@
+/*
+  ==============================================================================
+
+    WavetableBuilder.h
+    Part of WavemorpherSynthesizer project
+
+    Created: 17th October 2026
+    Author:  agent
+
+    Description: Background thread that watches the wavetable slot parameters,
+    builds the wavetable bank and the set of tables the five wavescanning
+    slots point at, and publishes them to the audio thread with an atomic
+    pointer swap. Anything the audio thread may still be reading is retired
+    rather than deleted, and only freed later on the message thread once the
+    audio thread can no longer see it. While the wavescan position is static
+    and the LFO is off it also bakes the blend of the two slots either side
+    of the position into a single table per octave. Wavetables imported from
+    disk are handed to it as well, and take up the imported wavetable
+    indices after the bank's, so a slot plays one when its user table is
+    set to it, just like a library table. A new import only ever goes into
+    indices no slot is set to, so it never changes what a slot plays.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "WavetableBank.h"
+
+/*!
+ @class UserWavetable
+ @abstract a single cycle imported from disk along with its octaves
+ @discussion keeps the cycle so its octaves can be built again if the sample rate changes
+
+ @namespace none
+ */
+class UserWavetable : public juce::ReferenceCountedObject
+{
+public:
+    using Ptr = juce::ReferenceCountedObjectPtr<UserWavetable>;
+
+    //--------------------------------------------------------------------------
+    /**
+     Build the octaves of an imported cycle, not to be called from the audio thread
+
+     @param name shown for the wavetable
+     @param the cycle, already resampled and normalised
+     @param sample rate to build the octaves for
+     */
+    UserWavetable(const juce::String& name, const juce::AudioBuffer<float>& cycle, double sampleRate);
+
+    /// Name shown for the wavetable
+    const juce::String name;
+
+    /// The imported cycle, kept to build the octaves again from
+    const juce::AudioBuffer<float> cycle;
+
+    /// Sample rate the octaves were built for
+    const double sampleRate;
+
+    /// The octaves the voices play
+    WavescanningSlot wavetable;
+};
+
+/*!
+ @class WavescanTables
+ @abstract immutable set of the wavetables currently loaded into the five slots
+ @discussion never modified once published, a new one is built for every change
+
+ @namespace none
+ */
+class WavescanTables : public juce::ReferenceCountedObject
+{
+public:
+    using Ptr = juce::ReferenceCountedObjectPtr<WavescanTables>;
+
+    /// Number of wavescanning slots
+    static constexpr int numSlots = 5;
+
+    /// Bank the slots point into, held so it outlives this set of tables
+    WavetableBank::Ptr bank;
+
+    /// Wavetable index of the table loaded into each slot, in the bank or one of the imported ones after it
+    int indices[numSlots] = { 0, 0, 0, 0, 0 };
+
+    /// Wavetables loaded into each slot
+    const WavescanningSlot* slots[numSlots] = { nullptr, nullptr, nullptr, nullptr, nullptr };
+
+    /// Imported wavetable loaded into each slot, held so it outlives this set of tables, null for the slots playing one from the bank
+    UserWavetable::Ptr userWavetables[numSlots];
+};
+
+/*!
+ @class MorphTable
+ @abstract blend of two wavescanning slots at a fixed wavescan position
+ @discussion one table per octave, so a voice can play a static wavescan position with a single oscillator
+
+ @namespace none
+ */
+class MorphTable : public juce::ReferenceCountedObject
+{
+public:
+    using Ptr = juce::ReferenceCountedObjectPtr<MorphTable>;
+
+    /// Tables the blend was made from, the morph table is only valid while these are the ones playing
+    WavescanTables::Ptr tables;
+
+    /// Wavescan position the blend was made for
+    float wavescanPosition = 0.0f;
+
+    /// Blended wavetable for each octave, including the guard samples
+    juce::AudioBuffer<float> octaves[WavescanningSlot::numWavetableOctaves];
+};
+
+/*!
+ @class WavetableBuilder
+ @abstract prepares wavetables away from the audio thread
+ @discussion audio thread only ever does an atomic load of the current tables
+
+ @namespace none
+ */
+class WavetableBuilder : private juce::Thread,
+                         private juce::Timer
+{
+public:
+    //--------------------------------------------------------------------------
+    /**
+     Initialization
+
+     @param value tree state holding the wavetype_one ... wavetype_five and usertable_one ... usertable_five parameters
+     @param library whose tables follow the factory ones in every bank built, may be null
+     */
+    WavetableBuilder(juce::AudioProcessorValueTreeState& parametersToWatch, WavetableLibrary::Ptr libraryToUse);
+
+    ~WavetableBuilder() override;
+
+    //--------------------------------------------------------------------------
+    /**
+     Set the sample rate the tables should be built for and start the builder thread
+
+     The very first call builds the tables on the calling thread so that there is
+     always something to play, after that any rebuilding happens in the background
+
+     @param sample rate
+     */
+    void prepare(double sampleRate);
+
+    //--------------------------------------------------------------------------
+    /**
+     Get the most recently published tables, safe to call from the audio thread
+
+     The pointer stays valid until at least the end of the block after this one,
+     take a WavescanTables::Ptr to it to keep it alive for longer
+     */
+    WavescanTables* getCurrentTables() const noexcept;
+
+    //--------------------------------------------------------------------------
+    /**
+     Get the most recently baked morph table, safe to call from the audio thread
+
+     May be null, or have been made for a different position or set of tables,
+     so check it matches before playing it. Stays valid for the same length of
+     time as getCurrentTables
+
+     */
+    MorphTable* getCurrentMorphTable() const noexcept;
+
+    //--------------------------------------------------------------------------
+    /**
+     Add imported wavetables, any thread but the audio thread
+
+     They go into the imported wavetable indices, from WavetableBank::getFirstImportedIndex onwards,
+     that no slot is set to, empty ones first and then ones whose earlier import no slot is playing,
+     so what the slots play never changes. Slots later set to them pick them up on the builder
+     thread's next poll
+
+     @param imported wavetables, in the order they should take the free indices
+     @return the number added, any more than there were free indices for are left out
+     */
+    int addImportedWavetables(const juce::ReferenceCountedArray<UserWavetable>& wavetables);
+
+    //--------------------------------------------------------------------------
+    /**
+     Get the number of imported wavetable indices no slot is set to, so an import knows how many it can add
+     */
+    int getNumFreeImportedIndices() const;
+
+    //--------------------------------------------------------------------------
+    /**
+     Get the names of the imported wavetables, in index order, empty for an index with nothing imported
+     */
+    juce::StringArray getImportedWavetableNames() const;
+
+    //--------------------------------------------------------------------------
+    /**
+     Get how many times wavetables have been imported, to tell when they have changed
+     */
+    juce::uint32 getNumImports() const;
+
+    //--------------------------------------------------------------------------
+    /**
+     Get the sample rate the tables are being built for, zero before the first prepare
+     */
+    double getSampleRate() const noexcept;
+
+    //--------------------------------------------------------------------------
+    /**
+     Called by the audio thread at the end of every processBlock so retired tables
+     can be reclaimed once no block could still be using them
+     */
+    void audioBlockFinished() noexcept;
+
+private:
+    //--------------------------------------------------------------------------
+    /// Builder thread, polls the slot parameters and rebuilds when they change
+    void run() override;
+
+    /// Message thread, frees retired tables that nothing references any more
+    void timerCallback() override;
+
+    /// Build and publish new tables if the sample rate or any slot has changed
+    void rebuildIfNeeded();
+
+    /// Get the wavetable index a slot's parameters are set to, -1 before prepare has looked them up
+    int getSlotIndex(int slot) const;
+
+    /// Is an imported wavetable index free for a new import, with no slot set to it
+    bool isImportedIndexFree(int importedIndex) const;
+
+    /// Bake and publish a new morph table if the wavescan position has settled somewhere new
+    void rebakeIfNeeded();
+
+    /// Swap in a new morph table, or none, for the audio thread
+    void publishMorphTable(MorphTable::Ptr newMorphTable);
+
+    /// Hold on to tables or a morph table the audio thread may still be reading until the timer can free them
+    void retire(WavescanTables::Ptr tables, MorphTable::Ptr morphTable);
+
+    //--------------------------------------------------------------------------
+    /// Parameters holding the wavetable each slot plays
+    juce::AudioProcessorValueTreeState& parameters;
+
+    /// Library given to every bank, may be null
+    WavetableLibrary::Ptr library;
+
+    /// IDs of the factory and user table parameters of each slot
+    const char* slotParameterIDs[WavescanTables::numSlots] = { "wavetype_one", "wavetype_two", "wavetype_three", "wavetype_four", "wavetype_five" };
+    const char* userTableParameterIDs[WavescanTables::numSlots] = { "usertable_one", "usertable_two", "usertable_three", "usertable_four", "usertable_five" };
+
+    /// Raw values of the factory and user table parameters of each slot, looked up once in prepare
+    std::atomic<float>* slotParameters[WavescanTables::numSlots] = { nullptr, nullptr, nullptr, nullptr, nullptr };
+    std::atomic<float>* userTableParameters[WavescanTables::numSlots] = { nullptr, nullptr, nullptr, nullptr, nullptr };
+
+    /// Raw values of the wavescan and lfo amount parameters, looked up once in prepare
+    std::atomic<float>* wavescanParameter = nullptr;
+    std::atomic<float>* lfoAmpParameter = nullptr;
+
+    /// Imported wavetables in index order, null where nothing has been imported, and the number of imports
+    UserWavetable::Ptr importedWavetables[WavetableBank::maxImportedWavetables];
+    juce::uint32 numImports = 0;
+
+    /// Protects the imported wavetables, shared with whichever thread finishes an import and the message thread
+    juce::CriticalSection importedWavetableLock;
+
+    /// Wavescan position seen on the previous poll, a position is only baked once it has stayed put for a poll
+    float lastWavescanPosition = -1.0f;
+
+    /// Sample rate requested by the processor
+    std::atomic<double> requestedSampleRate { 0.0 };
+
+    /// Held while building, so prepare and the builder thread never build at once
+    juce::CriticalSection buildLock;
+
+    /// Tables currently published, owned by the builder
+    WavescanTables::Ptr liveTables;
+
+    /// Raw pointer to the published tables read by the audio thread
+    std::atomic<WavescanTables*> currentTables { nullptr };
+
+    /// Morph table currently published, owned by the builder
+    MorphTable::Ptr liveMorphTable;
+
+    /// Raw pointer to the published morph table read by the audio thread
+    std::atomic<MorphTable*> currentMorphTable { nullptr };
+
+    /// Number of blocks the audio thread has finished
+    std::atomic<juce::uint32> audioBlockCount { 0 };
+
+    /// Tables and morph tables that have been replaced, waiting to be freed on the message thread
+    struct RetiredTables {
+        WavescanTables::Ptr tables;
+        MorphTable::Ptr morphTable;
+        juce::uint32 retiredAtBlock;
+    };
+    juce::Array<RetiredTables> retiredTables;
+
+    /// Protects the retired tables list shared by the builder and message threads
+    juce::CriticalSection retiredLock;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WavetableBuilder)
+};
@@ -0,0 +1,261 @@
+/*
+  ==============================================================================
+
+    WavetableImporter.cpp
+    Part of WavemorpherSynthesizer project
+
+    Created: 17th October 2026
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#include "WavetableImporter.h"
+
+/// Read the frame size a Serum style table was saved with from its clm chunk, zero if the file doesn't have one
+static int readSerumFrameSize(const juce::File& file)
+{
+    juce::FileInputStream stream(file);
+    char id[4];
+
+    // only wav files have the chunk
+    if (!stream.openedOk() || stream.read(id, 4) != 4 || std::memcmp(id, "RIFF", 4) != 0)
+        return 0;
+
+    stream.readInt();
+
+    if (stream.read(id, 4) != 4 || std::memcmp(id, "WAVE", 4) != 0)
+        return 0;
+
+    while (stream.read(id, 4) == 4)
+    {
+        const auto chunkSize = (juce::int64)(juce::uint32)stream.readInt();
+        const auto chunkStart = stream.getPosition();
+
+        // "<!>2048" followed by flags and the name of whatever wrote it
+        if (std::memcmp(id, "clm ", 4) == 0)
+        {
+            char text[16] = {};
+            const int numRead = stream.read(text, (int)juce::jmin(chunkSize, (juce::int64)sizeof(text) - 1));
+            const juce::String clm(text, (size_t)juce::jmax(0, numRead));
+
+            return clm.startsWith("<!>") ? clm.substring(3).getIntValue() : 0;
+        }
+
+        // every chunk is padded to an even length
+        if (!stream.setPosition(chunkStart + chunkSize + (chunkSize & 1)))
+            return 0;
+    }
+
+    return 0;
+}
+
+WavetableImporter::WavetableImporter(WavetableBuilder& builderToLoad)
+    : builder(builderToLoad)
+{
+}
+
+bool WavetableImporter::importFiles(const juce::Array<juce::File>& filesToImport)
+{
+    if (filesToImport.isEmpty() || importing.exchange(true))
+        return false;
+
+    files = filesToImport;
+    decodedFiles.clear();
+    decodedFiles.resize((size_t)files.size());
+    filesLeft = files.size();
+
+    // at most one build job per imported wavetable after the decoding, the count drops once the frames are picked
+    numJobs = files.size() + WavetableBank::maxImportedWavetables;
+    jobsFinished = 0;
+
+    setStatus(files.size() == 1 ? "Importing " + files.getFirst().getFileName() : "Importing " + juce::String(files.size()) + " files");
+
+    // every file decodes in parallel, the last one to finish picks the frames to build
+    for (int fileIndex = 0; fileIndex < files.size(); fileIndex++)
+        pool.addJob([this, fileIndex] { decodeFile(fileIndex); });
+
+    return true;
+}
+
+bool WavetableImporter::isImporting() const noexcept
+{
+    return importing.load();
+}
+
+double WavetableImporter::getProgress() const noexcept
+{
+    // jobs only ever finish and the expected count only ever drops, so this only ever rises
+    const int finished = jobsFinished.load();
+    return juce::jmin(1.0, (double)finished / juce::jmax(1, numJobs.load()));
+}
+
+juce::String WavetableImporter::getStatus() const
+{
+    const juce::ScopedLock sl(statusLock);
+    return status;
+}
+
+void WavetableImporter::decodeFile(int fileIndex)
+{
+    const auto& file = files.getReference(fileIndex);
+    auto& decoded = decodedFiles[(size_t)fileIndex];
+    decoded.name = file.getFileNameWithoutExtension();
+
+    // a manager each, the jobs run at the same time
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+
+    if (reader != nullptr && reader->lengthInSamples >= 2)
+    {
+        const auto length = reader->lengthInSamples;
+
+        // Serum style tables are frames one after another, of the size their clm chunk gives, or without one of Serum's
+        // usual size if the file is a whole number of them, anything else is a single cycle
+        const int clmFrameSize = readSerumFrameSize(file);
+        const int serumFrameSize = clmFrameSize > 0 ? clmFrameSize : (length % defaultSerumFrameSize == 0 ? defaultSerumFrameSize : 0);
+        const bool multiFrame = serumFrameSize >= 2 && serumFrameSize <= maxCycleLength && length >= 2 * serumFrameSize;
+        const int numFrames = multiFrame ? (int)juce::jmin(length / serumFrameSize, (juce::int64)maxFramesPerFile) : 1;
+        const int frameLength = multiFrame ? serumFrameSize : (int)juce::jmin(length, (juce::int64)maxCycleLength);
+
+        if (multiFrame || length <= maxCycleLength)
+        {
+            // only the first channel is used, the same as the factory tables
+            juce::AudioBuffer<float> samples(1, numFrames * frameLength);
+            reader->read(&samples, 0, numFrames * frameLength, 0, true, false);
+
+            // the mipmaps are built from a power of two, so each frame is stretched to one here, once
+            const int resampledLength = juce::nextPowerOfTwo(frameLength);
+
+            for (int frame = 0; frame < numFrames; frame++)
+            {
+                juce::AudioBuffer<float> resampled(1, resampledLength);
+                MipmapBuilder::resampleCycle(samples.getReadPointer(0, frame * frameLength), frameLength, resampled.getWritePointer(0), resampledLength);
+                decoded.frames.add(resampled);
+            }
+        }
+    }
+
+    ++jobsFinished;
+
+    if (--filesLeft == 0)
+        chooseFrames();
+}
+
+void WavetableImporter::chooseFrames()
+{
+    // every frame of every file, in the order the files were chosen
+    juce::Array<const juce::AudioBuffer<float>*> frames;
+    juce::StringArray frameNames;
+    juce::StringArray failedFiles;
+
+    for (int fileIndex = 0; fileIndex < files.size(); fileIndex++)
+    {
+        const auto& decoded = decodedFiles[(size_t)fileIndex];
+
+        if (decoded.frames.isEmpty())
+            failedFiles.add(files.getReference(fileIndex).getFileName());
+
+        for (int frame = 0; frame < decoded.frames.size(); frame++)
+        {
+            frames.add(&decoded.frames.getReference(frame));
+            frameNames.add(decoded.frames.size() > 1 ? decoded.name + " " + juce::String(frame + 1) : decoded.name);
+        }
+    }
+
+    // only into the imported wavetables no slot is set to, so the import never changes what a slot plays
+    const int numFree = builder.getNumFreeImportedIndices();
+
+    if (frames.isEmpty() || numFree == 0)
+    {
+        setStatus(frames.isEmpty() ? "Couldn't import " + failedFiles.joinIntoString(", ")
+                                   : juce::String("Couldn't import, every imported wavetable is playing in a slot"));
+        numJobs = files.size();
+        importing = false;
+        return;
+    }
+
+    // with more frames than can be imported, spread the ones taken evenly from the first frame to the last
+    const int numToLoad = juce::jmin(frames.size(), numFree);
+    int chosenFrames[WavetableBank::maxImportedWavetables];
+
+    for (int slot = 0; slot < numToLoad; slot++)
+        chosenFrames[slot] = frames.size() > numToLoad && numToLoad > 1
+                           ? juce::roundToInt((double)slot * (frames.size() - 1) / (numToLoad - 1))
+                           : slot;
+
+    // one gain for all of them, so the loudest peaks at full scale and the levels between them are kept
+    float peak = 0.0f;
+
+    for (int slot = 0; slot < numToLoad; slot++)
+    {
+        const auto* frame = frames[chosenFrames[slot]];
+        peak = juce::jmax(peak, frame->getMagnitude(0, 0, frame->getNumSamples()));
+    }
+
+    const float gain = peak > 0.0f ? 1.0f / peak : 1.0f;
+
+    // build for the rate the builder is using, it builds them again itself if that changes
+    const double builderSampleRate = builder.getSampleRate();
+    buildSampleRate = builderSampleRate > 0.0 ? builderSampleRate : 44100.0;
+
+    chosenCycles.clear();
+    chosenNames.clear();
+
+    for (int slot = 0; slot < numToLoad; slot++)
+    {
+        juce::AudioBuffer<float> cycle(*frames[chosenFrames[slot]]);
+        cycle.applyGain(gain);
+
+        chosenCycles.add(cycle);
+        chosenNames.add(frameNames[chosenFrames[slot]]);
+    }
+
+    finishedStatus = "Imported " + (frames.size() == 1 ? frameNames[0] : juce::String(frames.size()) + " frames");
+
+    if (!failedFiles.isEmpty())
+        finishedStatus += ", couldn't import " + failedFiles.joinIntoString(", ");
+
+    // everything a build job reads is written before it is queued, each writes only its own wavetable
+    numJobs = files.size() + numToLoad;
+    buildsLeft = numToLoad;
+
+    for (int slot = 0; slot < numToLoad; slot++)
+        pool.addJob([this, slot] { buildWavetable(slot); });
+}
+
+void WavetableImporter::buildWavetable(int slot)
+{
+    builtWavetables[slot] = new UserWavetable(chosenNames[slot], chosenCycles.getReference(slot), buildSampleRate);
+
+    ++jobsFinished;
+
+    if (--buildsLeft == 0)
+        finishImport();
+}
+
+void WavetableImporter::finishImport()
+{
+    juce::ReferenceCountedArray<UserWavetable> wavetables;
+
+    for (int slot = 0; slot < chosenCycles.size(); slot++)
+    {
+        wavetables.add(builtWavetables[slot]);
+        builtWavetables[slot] = nullptr;
+    }
+
+    // a slot may have been set to one of the free indices since they were counted, which leaves some out
+    const int numAdded = builder.addImportedWavetables(wavetables);
+
+    setStatus(numAdded < wavetables.size() ? finishedStatus + ", " + juce::String(wavetables.size() - numAdded) + " left out as their wavetables are now playing"
+                                           : finishedStatus);
+    importing = false;
+}
+
+void WavetableImporter::setStatus(const juce::String& newStatus)
+{
+    const juce::ScopedLock sl(statusLock);
+    status = newStatus;
+}
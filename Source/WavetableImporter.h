@@ -0,0 +1,155 @@
+/*
+  ==============================================================================
+
+    WavetableImporter.h
+    Part of WavemorpherSynthesizer project
+
+    Created: 17th October 2026
+    Author:  agent
+
+    Description: Imports wavetables from WAV, AIFF and FLAC files on disk
+    without ever blocking the message or audio threads. Each file is decoded
+    on a background thread pool, as a Serum style multi-frame table when it
+    has a clm chunk giving its frame size or is a whole number of Serum's
+    usual 2048 sample frames, otherwise as a single cycle, and each frame is
+    resampled to a power of two length. Once every file is in, the frames to
+    load are picked and normalised together, and each has its octaves built
+    by its own job on the pool, then they are handed to the WavetableBuilder
+    as imported wavetables, for the slot drop downs to pick. They only take
+    imported wavetables no slot is set to, so an import never changes what
+    the slots play. A single table of more frames than there is room for has
+    evenly spaced frames picked from it.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "WavetableBuilder.h"
+
+/*!
+ @class WavetableImporter
+ @abstract background decoding, resampling, normalising and mipmapping of wavetables from disk
+ @discussion one import runs at a time, its progress can be polled from any thread
+
+ @namespace none
+ */
+class WavetableImporter
+{
+public:
+    //--------------------------------------------------------------------------
+    /**
+     Initialization
+
+     @param builder the imported wavetables are handed to
+     */
+    WavetableImporter(WavetableBuilder& builderToLoad);
+
+    //--------------------------------------------------------------------------
+    /**
+     Start importing files in the background, returning straight away
+
+     The frames of every file are taken in order into the imported wavetables no slot is set to,
+     with evenly spaced frames picked if there are more than there is room for
+
+     @param files to import
+     @return false if there was nothing to import or an import is already running
+     */
+    bool importFiles(const juce::Array<juce::File>& files);
+
+    //--------------------------------------------------------------------------
+    /**
+     Is an import running
+     */
+    bool isImporting() const noexcept;
+
+    //--------------------------------------------------------------------------
+    /**
+     Get how far through the current import is, from 0 to 1
+     */
+    double getProgress() const noexcept;
+
+    //--------------------------------------------------------------------------
+    /**
+     Get a description of what the current or last import is doing or did
+     */
+    juce::String getStatus() const;
+
+    /// Most frames read from a single file
+    static constexpr int maxFramesPerFile = 256;
+
+    /// Longest file taken as a single cycle, and the longest frame of a multi-frame file
+    static constexpr int maxCycleLength = 16384;
+
+    /// Frame size of a multi-frame file without a clm chunk, what Serum saves
+    static constexpr int defaultSerumFrameSize = 2048;
+
+    /// File patterns of the formats that can be imported
+    static constexpr const char* fileWildcard = "*.wav;*.aif;*.aiff;*.flac";
+
+private:
+    //--------------------------------------------------------------------------
+    /// Decode one file and split it into frames, run on the pool
+    void decodeFile(int fileIndex);
+
+    /// Pick and normalise the frames to load once every file is decoded and queue a build job for each, run on the pool
+    void chooseFrames();
+
+    /// Build the octaves of one chosen frame, run on the pool
+    void buildWavetable(int slot);
+
+    /// Hand the built wavetables to the builder once the last is done, run on the pool
+    void finishImport();
+
+    /// Set the status shown for the import
+    void setStatus(const juce::String& newStatus);
+
+    //--------------------------------------------------------------------------
+    /// Frames of one decoded file, each already resampled to a power of two length
+    struct DecodedFile
+    {
+        juce::String name;
+        juce::Array<juce::AudioBuffer<float>> frames;
+    };
+
+    /// Builder the imported wavetables are handed to
+    WavetableBuilder& builder;
+
+    /// Files being imported and what has been decoded from each, each decoding job only touches its own
+    juce::Array<juce::File> files;
+    std::vector<DecodedFile> decodedFiles;
+
+    /// Number of files still being decoded, the job that decodes the last one picks the frames
+    std::atomic<int> filesLeft { 0 };
+
+    /// Normalised frames picked to load, and their names, written before their build jobs are queued
+    juce::Array<juce::AudioBuffer<float>> chosenCycles;
+    juce::StringArray chosenNames;
+
+    /// Wavetable built by each build job, each job only touches its own
+    UserWavetable::Ptr builtWavetables[WavetableBank::maxImportedWavetables];
+
+    /// Number of frames still being built, the job that builds the last one finishes the import
+    std::atomic<int> buildsLeft { 0 };
+
+    /// Sample rate the frames are built for, and the status shown once they are
+    double buildSampleRate = 44100.0;
+    juce::String finishedStatus;
+
+    /// Is an import running
+    std::atomic<bool> importing { false };
+
+    /// Decoding and build jobs finished and expected, the progress is one over the other so it never goes backwards
+    std::atomic<int> jobsFinished { 0 };
+    std::atomic<int> numJobs { 1 };
+
+    /// Description of the import, read by the editor
+    juce::String status;
+    juce::CriticalSection statusLock;
+
+    /// Threads the import runs on, declared last so any running job finishes before the rest is destroyed
+    juce::ThreadPool pool { 2 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WavetableImporter)
+};
@@ -0,0 +1,272 @@
+/*
+  ==============================================================================
+
+    WavetableLibrary.cpp
+    Part of WavemorpherSynthesizer project
+
+    Created: 17th October 2026
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#include "WavetableLibrary.h"
+
+/// Round an offset in the file up to a multiple of an alignment
+static juce::uint64 roundUp(juce::uint64 offset, juce::uint64 alignment)
+{
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+/// Number of bytes a cycle or octave takes up in the file, padded so whatever follows it stays aligned
+static juce::uint64 getPaddedSize(int numSamples)
+{
+    return roundUp(sizeof(float) * (juce::uint64)numSamples, FactoryMipmaps::alignment);
+}
+
+WavetableLibrary::WavetableLibrary(std::unique_ptr<juce::MemoryMappedFile> file)
+    : mappedFile(std::move(file))
+{
+    auto* data = static_cast<const char*>(mappedFile->getData());
+
+    header = reinterpret_cast<const FileHeader*>(data);
+    index = reinterpret_cast<const IndexEntry*>(data + header->indexOffset);
+}
+
+WavetableLibrary::Ptr WavetableLibrary::open(const juce::File& file)
+{
+    if (!file.existsAsFile())
+        return nullptr;
+
+    // only the pages that are read get loaded, so mapping even a very large library is instant
+    auto mapped = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly, false);
+
+    if (mapped->getData() == nullptr || !isValid(*mapped))
+        return nullptr;
+
+    return new WavetableLibrary(std::move(mapped));
+}
+
+bool WavetableLibrary::isValid(const juce::MemoryMappedFile& mapped)
+{
+    const auto fileSize = (juce::uint64)mapped.getSize();
+
+    if (fileSize < sizeof(FileHeader))
+        return false;
+
+    auto* data = static_cast<const char*>(mapped.getData());
+    auto* fileHeader = reinterpret_cast<const FileHeader*>(data);
+
+    if (std::memcmp(fileHeader->magic, fileMagic, sizeof(fileMagic)) != 0
+        || fileHeader->version != currentVersion
+        || fileHeader->byteOrderMark != byteOrderMark
+        || fileHeader->numOctaves != (juce::uint32)WavescanningSlot::numWavetableOctaves
+        || fileHeader->pageSize != pageSize
+        || !(fileHeader->sampleRate > 0.0)
+        || fileHeader->dataOffset > fileSize)
+        return false;
+
+    // the index has to fit in the file before any of it can be read, compared against what is left after
+    // the offset so a corrupt size can't wrap round and pass
+    if (fileHeader->indexOffset % alignof(IndexEntry) != 0
+        || fileHeader->indexOffset > fileSize
+        || fileHeader->numTables > (juce::uint32)maxTables
+        || fileHeader->numTables > (fileSize - fileHeader->indexOffset) / sizeof(IndexEntry))
+        return false;
+
+    auto* entries = reinterpret_cast<const IndexEntry*>(data + fileHeader->indexOffset);
+
+    // a table running off the end of the file would fault when played rather than when opened, so check them all now
+    auto fitsInFile = [fileSize, dataOffset = fileHeader->dataOffset](juce::uint64 offset, juce::uint64 numSamples)
+    {
+        return offset % FactoryMipmaps::alignment == 0
+            && offset >= dataOffset && offset <= fileSize
+            && numSamples <= (fileSize - offset) / sizeof(float);
+    };
+
+    for (juce::uint32 table = 0; table < fileHeader->numTables; table++)
+    {
+        const auto& entry = entries[table];
+
+        if (entry.cycleLength < 2 || entry.cycleLength > (juce::uint32)maxCycleLength || !fitsInFile(entry.cycleOffset, entry.cycleLength))
+            return false;
+
+        // the octaves are power of two lengths between the builder's smallest table and the cycle stretched to a power of two,
+        // which the oscillator's fixed point phase depends on
+        const auto cycleSize = (juce::uint32)juce::nextPowerOfTwo((int)entry.cycleLength);
+        const auto minOctaveLength = juce::jmin((juce::uint32)MipmapBuilder::minTableSize, cycleSize);
+
+        for (int octave = 0; octave < WavescanningSlot::numWavetableOctaves; octave++)
+        {
+            const auto octaveLength = entry.octaveLengths[octave];
+
+            if (octaveLength < minOctaveLength || octaveLength > cycleSize || !juce::isPowerOfTwo(octaveLength)
+                || !fitsInFile(entry.octaveOffsets[octave], octaveLength + (juce::uint64)WavetableOscillator::numGuardSamples))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+bool WavetableLibrary::write(const juce::File& file, double sampleRate, const juce::StringArray& names, const juce::Array<juce::AudioBuffer<float>>& cycles)
+{
+    jassert(names.size() == cycles.size());
+
+    const int numTables = juce::jmin(names.size(), cycles.size(), maxTables);
+
+    FileHeader fileHeader {};
+    std::memcpy(fileHeader.magic, fileMagic, sizeof(fileMagic));
+    fileHeader.version = currentVersion;
+    fileHeader.byteOrderMark = byteOrderMark;
+    fileHeader.numTables = (juce::uint32)numTables;
+    fileHeader.numOctaves = (juce::uint32)WavescanningSlot::numWavetableOctaves;
+    fileHeader.pageSize = pageSize;
+    fileHeader.sampleRate = sampleRate;
+    fileHeader.indexOffset = roundUp(sizeof(FileHeader), alignof(IndexEntry));
+    fileHeader.dataOffset = roundUp(fileHeader.indexOffset + (juce::uint64)numTables * sizeof(IndexEntry), pageSize);
+
+    // the octave lengths only depend on the cycle length and sample rate, so the whole index can be laid out before anything is built
+    std::vector<IndexEntry> entries((size_t)numTables);
+    MipmapBuilder mipmapBuilder(sampleRate);
+    juce::uint64 offset = fileHeader.dataOffset;
+
+    for (int table = 0; table < numTables; table++)
+    {
+        auto& entry = entries[(size_t)table];
+        const int cycleLength = cycles.getReference(table).getNumSamples();
+
+        if (cycleLength < 2 || cycleLength > maxCycleLength)
+            return false;
+
+        names[table].copyToUTF8(entry.name, maxNameLength);
+        entry.cycleLength = (juce::uint32)cycleLength;
+        entry.cycleOffset = offset;
+
+        juce::uint64 octaveOffset = offset + getPaddedSize(cycleLength);
+
+        for (int octave = 0; octave < WavescanningSlot::numWavetableOctaves; octave++)
+        {
+            const int numHarmonics = mipmapBuilder.getNumHarmonics(octave, WavescanningSlot::numWavetableOctaves);
+            const int octaveLength = MipmapBuilder::getTableSize(numHarmonics, juce::nextPowerOfTwo(cycleLength));
+
+            entry.octaveLengths[octave] = (juce::uint32)octaveLength;
+            entry.octaveOffsets[octave] = octaveOffset;
+            octaveOffset += getPaddedSize(octaveLength + WavetableOscillator::numGuardSamples);
+        }
+
+        // every table starts on its own page, so playing one never pulls in its neighbours
+        entry.dataSize = octaveOffset - offset;
+        offset = roundUp(octaveOffset, pageSize);
+    }
+
+    // write to a temporary file first, so a library that is open elsewhere is never seen half written
+    juce::TemporaryFile temporaryFile(file);
+
+    {
+        juce::FileOutputStream out(temporaryFile.getFile());
+
+        if (!out.openedOk())
+            return false;
+
+        auto padTo = [&out](juce::uint64 position)
+        {
+            while ((juce::uint64)out.getPosition() < position)
+                out.writeByte(0);
+        };
+
+        out.write(&fileHeader, sizeof(FileHeader));
+        padTo(fileHeader.indexOffset);
+        out.write(entries.data(), entries.size() * sizeof(IndexEntry));
+
+        // one table's octaves at a time, however many tables there are
+        juce::AudioBuffer<float> octaves[WavescanningSlot::numWavetableOctaves];
+
+        for (int table = 0; table < numTables; table++)
+        {
+            const auto& entry = entries[(size_t)table];
+            const auto& cycle = cycles.getReference(table);
+
+            padTo(entry.cycleOffset);
+            out.write(cycle.getReadPointer(0), sizeof(float) * entry.cycleLength);
+
+            mipmapBuilder.build(cycle.getReadPointer(0), cycle.getNumSamples(), octaves, WavescanningSlot::numWavetableOctaves);
+
+            for (int octave = 0; octave < WavescanningSlot::numWavetableOctaves; octave++)
+            {
+                const int numSamples = octaves[octave].getNumSamples();
+
+                // the index was laid out from the same sizes the builder uses
+                if (numSamples != (int)entry.octaveLengths[octave] + WavetableOscillator::numGuardSamples)
+                {
+                    jassertfalse;
+                    return false;
+                }
+
+                padTo(entry.octaveOffsets[octave]);
+                out.write(octaves[octave].getReadPointer(0), sizeof(float) * (size_t)numSamples);
+            }
+        }
+
+        padTo(offset);
+        out.flush();
+
+        if (out.getStatus().failed())
+            return false;
+    }
+
+    return temporaryFile.overwriteTargetFileWithTemporary();
+}
+
+juce::File WavetableLibrary::getDefaultFile()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("WavemorpherSynthesizer")
+        .getChildFile(juce::String("Wavetables") + fileExtension);
+}
+
+int WavetableLibrary::getNumTables() const noexcept
+{
+    return (int)header->numTables;
+}
+
+juce::String WavetableLibrary::getName(int table) const
+{
+    const auto& entry = getEntry(table);
+
+    size_t length = 0;
+    while (length < (size_t)maxNameLength && entry.name[length] != 0)
+        length++;
+
+    return juce::String::fromUTF8(entry.name, (int)length);
+}
+
+double WavetableLibrary::getSampleRate() const noexcept
+{
+    return header->sampleRate;
+}
+
+const float* WavetableLibrary::getCycle(int table, int& cycleLength) const noexcept
+{
+    const auto& entry = getEntry(table);
+    cycleLength = (int)entry.cycleLength;
+
+    return reinterpret_cast<const float*>(static_cast<const char*>(mappedFile->getData()) + entry.cycleOffset);
+}
+
+const float* WavetableLibrary::getOctave(int table, int octave, int& octaveLength) const noexcept
+{
+    jassert(juce::isPositiveAndBelow(octave, WavescanningSlot::numWavetableOctaves));
+
+    const auto& entry = getEntry(table);
+    octaveLength = (int)entry.octaveLengths[octave];
+
+    return reinterpret_cast<const float*>(static_cast<const char*>(mappedFile->getData()) + entry.octaveOffsets[octave]);
+}
+
+const WavetableLibrary::IndexEntry& WavetableLibrary::getEntry(int table) const noexcept
+{
+    jassert(juce::isPositiveAndBelow(table, getNumTables()));
+
+    return index[table];
+}
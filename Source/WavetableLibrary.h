@@ -0,0 +1,184 @@
+/*
+  ==============================================================================
+
+    WavetableLibrary.h
+    Part of WavemorpherSynthesizer project
+
+    Created: 17th October 2026
+    Author:  agent
+
+    Description: On disk library of wavetables that have already been band
+    limited, opened with a juce::MemoryMappedFile so that no table is read
+    until a voice plays it. The file starts with a header and an index
+    giving each table's name, lengths and offset, followed by the tables
+    themselves, each starting on a page boundary. A table holds its raw
+    cycle and then its octaves, each with its guard samples on the end and
+    padded to FactoryMipmaps::alignment bytes, so oscillators read straight
+    from the mapped pages. Opening a library only reads the header and the
+    index however big it is, and only the pages of the tables actually
+    played become resident.
+
+    Every field and sample is stored in the byte order of the machine that
+    wrote it, so the tables can be played straight from the mapping, and a
+    marker in the header stops a library written on a machine of the other
+    byte order from opening.
+
+    The octaves are built for the sample rate stored in the header and are
+    used as they are at that rate or any higher one. At a lower rate they
+    could alias, so the slot builds its octaves again from the raw cycle.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "WavescanningSlot.h"
+#include "FactoryMipmaps.h"
+
+/*!
+ @class WavetableLibrary
+ @abstract read only, memory mapped collection of pre-mipmapped wavetables
+ @discussion shared by every bank built from it, the mapping lasts as long as the last reference
+
+ @namespace none
+ */
+class WavetableLibrary : public juce::ReferenceCountedObject
+{
+public:
+    using Ptr = juce::ReferenceCountedObjectPtr<WavetableLibrary>;
+
+    //--------------------------------------------------------------------------
+    /**
+     Map a library file and check its header and index
+
+     @param library file
+     @return the library, or null if the file is missing or isn't a valid library
+     */
+    static Ptr open(const juce::File& file);
+
+    //--------------------------------------------------------------------------
+    /**
+     Write a library, building the octaves of each cycle with the MipmapBuilder
+
+     Not for the audio thread, this transforms every cycle and writes the whole file
+
+     @param file to write, replaced if it already exists
+     @param sample rate to build the octaves for, the lowest rate the library should play at without rebuilding them
+     @param name of each table, cut short at maxNameLength characters
+     @param single cycle of each table, from the first channel of each buffer, from 2 to maxCycleLength samples, only the first maxTables are written
+     @return true if the file was written
+     */
+    static bool write(const juce::File& file, double sampleRate, const juce::StringArray& names, const juce::Array<juce::AudioBuffer<float>>& cycles);
+
+    //--------------------------------------------------------------------------
+    /**
+     Get the library the plugin opens at start up, in the user's application data folder
+     */
+    static juce::File getDefaultFile();
+
+    //--------------------------------------------------------------------------
+    /**
+     Get the number of tables in the library
+     */
+    int getNumTables() const noexcept;
+
+    //--------------------------------------------------------------------------
+    /**
+     Get the name of a table
+
+     @param index of the table
+     */
+    juce::String getName(int table) const;
+
+    //--------------------------------------------------------------------------
+    /**
+     Get the sample rate the octaves were built for
+     */
+    double getSampleRate() const noexcept;
+
+    //--------------------------------------------------------------------------
+    /**
+     Get the raw cycle of a table, read from the mapped file
+
+     @param index of the table
+     @param set to the number of samples in the cycle
+     */
+    const float* getCycle(int table, int& cycleLength) const noexcept;
+
+    //--------------------------------------------------------------------------
+    /**
+     Get one octave of a table, read from the mapped file
+
+     The octave has WavetableOscillator::numGuardSamples repeats of its start on the end
+
+     @param index of the table
+     @param index of the octave
+     @param set to the length of the octave, not counting the guard samples
+     */
+    const float* getOctave(int table, int octave, int& octaveLength) const noexcept;
+
+    /// File extension of wavetable libraries
+    static constexpr const char* fileExtension = ".wmtl";
+
+    /// Longest table name stored, including the terminating null
+    static constexpr int maxNameLength = 64;
+
+    /// Most tables a library can hold, over 2 GB of 2048 sample cycles and their octaves, so the user table parameters cover the same range whatever library is open
+    static constexpr int maxTables = 65536;
+
+    /// Longest raw cycle a table can have
+    static constexpr int maxCycleLength = 65536;
+
+private:
+    //--------------------------------------------------------------------------
+    /// Start of the file, every field in the writer's byte order
+    struct FileHeader
+    {
+        char magic[8];                      ///< "WMWTLIB" and a null
+        juce::uint32 version;               ///< format version, currently 2
+        juce::uint32 byteOrderMark;         ///< byteOrderMark as written, reads back differently on a machine of the other byte order
+        juce::uint32 numTables;             ///< number of entries in the index
+        juce::uint32 numOctaves;            ///< octaves per table, must match WavescanningSlot::numWavetableOctaves
+        juce::uint32 pageSize;              ///< alignment of every table's data
+        double sampleRate;                  ///< sample rate the octaves were built for
+        juce::uint64 indexOffset;           ///< byte offset of the index
+        juce::uint64 dataOffset;            ///< byte offset of the first table
+    };
+
+    /// One table in the index, straight after the header
+    struct IndexEntry
+    {
+        char name[maxNameLength];                                           ///< null terminated name
+        juce::uint32 cycleLength;                                           ///< samples in the raw cycle
+        juce::uint32 octaveLengths[WavescanningSlot::numWavetableOctaves];  ///< samples in each octave, not counting guard samples, a power of two
+        juce::uint64 octaveOffsets[WavescanningSlot::numWavetableOctaves];  ///< byte offset of each octave from the start of the file
+        juce::uint64 cycleOffset;                                           ///< byte offset of the raw cycle, page aligned
+        juce::uint64 dataSize;                                              ///< bytes of the table's cycle and octaves, padding included
+    };
+
+    /// Only made by open, once the file is known to be valid
+    WavetableLibrary(std::unique_ptr<juce::MemoryMappedFile> mappedFile);
+
+    /// Check the header and that every table lies inside the file
+    static bool isValid(const juce::MemoryMappedFile& mappedFile);
+
+    /// Get an entry in the mapped index
+    const IndexEntry& getEntry(int table) const noexcept;
+
+    //--------------------------------------------------------------------------
+    /// Identifies a library file, format version written, marker of the byte order written and the page size the tables are aligned to
+    static constexpr char fileMagic[8] = { 'W', 'M', 'W', 'T', 'L', 'I', 'B', 0 };
+    static constexpr juce::uint32 currentVersion = 2;
+    static constexpr juce::uint32 byteOrderMark = 0x01020304;
+    static constexpr juce::uint32 pageSize = 4096;
+
+    /// The mapped file, kept for as long as anything might read from the library
+    std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+
+    /// Start of the mapped header and index
+    const FileHeader* header = nullptr;
+    const IndexEntry* index = nullptr;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WavetableLibrary)
+};
@@ -9,6 +9,8 @@
     Description: Class for generating the tone from the wavetable file it is 
     handed at the specifed frequency. Uses cubic spline interpolation to smooth 
     output. Quite short so I didn't feel a seperate .cpp file was necessary.
+    Wavetables handed over must have numGuardSamples copies of their first
+    samples appended, so the interpolation never has to wrap its index.
     Some aspects from: https://docs.juce.com/master/tutorial_wavetable_synth.html
 
   ==============================================================================
@@ -18,27 +20,90 @@
 
 #include <JuceHeader.h>
 
+// instruction sets the block renderer can use, anything else falls back to the per sample path
+#if JUCE_INTEL
+ #include <immintrin.h>
+ #define WAVETABLE_OSCILLATOR_SSE 1
+ #if defined (__AVX2__)
+  #define WAVETABLE_OSCILLATOR_AVX2 1
+ #endif
+#elif JUCE_ARM && (defined (__ARM_NEON) || defined (__ARM_NEON__))
+ #include <arm_neon.h>
+ #define WAVETABLE_OSCILLATOR_NEON 1
+#endif
+
 /*!
  @class WavetableOscillator
  @abstract Class for playing sound from juce::AudioBuffer
- @discussion input wavetable is played at a set frequency
+ @discussion input wavetable is played at a set frequency. Power of two
+ wavetables use a 32 bit fixed point phase, where the top bits are the index
+ and the rest the fraction, anything else uses a floating point index.
 
  @namespace none
  */
 class WavetableOscillator
 {
 public:
+    /// Samples from the start of a wavetable repeated after its end, enough for the spline to read past the last index
+    static constexpr int numGuardSamples = 2;
+
     //--------------------------------------------------------------------------
     /**
     Initialization
 
-    @param wavetable that is to be played
+    Nothing is played until a wavetable is handed over with reset, so the
+    oscillator can live inside the voice and be reused for every note
     */
-    WavetableOscillator(juce::AudioBuffer<float> wavetableToUse)
-        : wavetable(wavetableToUse),
-        tableSize(wavetable.getNumSamples())
+    WavetableOscillator() = default;
+
+    //--------------------------------------------------------------------------
+    /**
+    Start playing a wavetable from the beginning, called on every note on
+
+    Only stores a pointer, no allocation or copying of the wavetable
+
+    @param wavetable that is to be played including guard samples, not copied so it must outlive the note
+    */
+    void reset(const juce::AudioBuffer<float>& wavetableToUse) noexcept
     {
-        jassert(wavetable.getNumChannels() == 1);
+        jassert(wavetableToUse.getNumChannels() == 1);
+
+        wavetable = wavetableToUse.getReadPointer(0);
+        setTableSize(wavetableToUse.getNumSamples() - numGuardSamples, 0.0);
+        crossfadeRemaining = 0;
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+    Swap the wavetable being played without a click
+
+    The old table keeps being read and is crossfaded out, so it must stay alive
+    for the length of the crossfade
+
+    @param new wavetable to be played including guard samples, not copied
+    @param number of samples to crossfade from the old wavetable over
+    */
+    void setWavetable(const juce::AudioBuffer<float>& newWavetable, int crossfadeSamples)
+    {
+        jassert(newWavetable.getNumChannels() == 1);
+
+        auto newTableSize = newWavetable.getNumSamples() - numGuardSamples;
+
+        if (newTableSize == tableSize && crossfadeSamples > 0)
+        {
+            // same length, so the same index can be read from both tables while fading
+            previousWavetable = wavetable;
+            crossfadeLength = crossfadeSamples;
+            crossfadeRemaining = crossfadeSamples;
+        }
+        else
+        {
+            // different length, keep the phase where it is in the new table
+            setTableSize(newTableSize, getNormalisedPhase());
+            crossfadeRemaining = 0;
+        }
+
+        wavetable = newWavetable.getReadPointer(0);
     }
 
     //--------------------------------------------------------------------------
@@ -50,8 +115,19 @@ public:
     */
     void setFrequency(float frequency, float sampleRate)
     {
-        auto tableSizeOverSampleRate = (float)tableSize / sampleRate;
-        tableDelta = frequency * tableSizeOverSampleRate;
+        cyclesPerSample = (double)frequency / (double)sampleRate;
+        updateDeltas();
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+    Does this oscillator use the fixed point phase accumulator
+
+    True whenever the current wavetable length is a power of two
+    */
+    bool isUsingFixedPointPhase() const noexcept
+    {
+        return fixedPointPhase;
     }
 
     //--------------------------------------------------------------------------
@@ -62,19 +138,95 @@ public:
     */
     forcedinline float getNextSample() noexcept
     {
-        // get number of samples in the wavetable
-        auto tableSize = (unsigned int)wavetable.getNumSamples();
+        int n0;
+        float alpha;
+
+        if (fixedPointPhase)
+        {
+            // index and fraction are just the top and bottom bits of the phase, which wraps by itself
+            n0 = (int)(phase >> indexShift);
+            alpha = (float)(phase & fractionMask) * fractionScale;
+            phase += phaseDelta;
+        }
+        else
+        {
+            n0 = (int)currentIndex;
+            alpha = currentIndex - (float)n0;
+
+            // if current index + delta is larger than table size. subtract table size
+            if ((currentIndex += tableDelta) >= (float)tableSize)
+                currentIndex -= (float)tableSize;
+        }
 
-        auto currentSample = getSplineOut(currentIndex);
+        auto currentSample = getSplineOut(wavetable, n0, alpha);
 
-        // if current index + delta is larger than table size. subtract table size
-        if ((currentIndex += tableDelta) > (float)tableSize) 
-            currentIndex -= (float)tableSize;
+        // fade out of the previous wavetable if it has just been swapped
+        if (crossfadeRemaining > 0)
+        {
+            auto fade = (float)crossfadeRemaining / (float)crossfadeLength;
+            currentSample += (getSplineOut(previousWavetable, n0, alpha) - currentSample) * fade;
+            --crossfadeRemaining;
+        }
 
         // return sample
         return currentSample;
     }
 
+    //--------------------------------------------------------------------------
+    /**
+    Render a block of samples
+
+    Works out the index of a whole register's worth of samples at once, gathers
+    the spline points and evaluates the cubic for every lane together using
+    AVX2, SSE or NEON depending on the target. The guard samples mean the
+    gather needs no modulo. With the fixed point phase the index and fraction
+    are a shift and a mask, otherwise the phase wrap is a mask rather than a
+    branch.
+
+    @param buffer to write the samples to, overwritten rather than added to
+    @param number of samples to render
+    */
+    void renderBlock(float* dest, int numSamples) noexcept
+    {
+        int sample = 0;
+
+        // samples still inside a crossfade after a wavetable swap take the per sample path
+        while (crossfadeRemaining > 0 && sample < numSamples)
+            dest[sample++] = getNextSample();
+
+        if (fixedPointPhase)
+            sample = renderFixedPointPhase(dest, sample, numSamples);
+        else
+            sample = renderFloatIndex(dest, sample, numSamples);
+
+        // whatever is left over that doesn't fill a register
+        for (; sample < numSamples; sample++)
+            dest[sample] = getNextSample();
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+    Move the phase on as if a number of samples had been rendered, without rendering them
+
+    Lets an oscillator whose output isn't needed for a block stay in phase with
+    the ones that are, so it can be brought back in without a discontinuity
+
+    @param number of samples to skip
+    */
+    void skip(int numSamples) noexcept
+    {
+        if (fixedPointPhase)
+        {
+            phase += phaseDelta * (juce::uint32)numSamples;
+        }
+        else
+        {
+            currentIndex = (float)std::fmod((double)currentIndex + (double)tableDelta * numSamples, (double)tableSize);
+        }
+
+        crossfadeRemaining = juce::jmax(0, crossfadeRemaining - numSamples);
+    }
+
     //--------------------------------------------------------------------------
     /**
     Get cubic spline interpolated output
@@ -84,16 +236,15 @@ public:
     Translated across from a function on Matthew's github
     https://github.com/mhamilt/AudioEffectsSuite/blob/bfa9a94f9bb57817b77ce8360e5afdb8e92bb076/DelayEffects/SimpleDelay.cpp#L97-L106
 
-    @param current index in the wavetable
+    @param wavetable to read from
+    @param index of the sample before the point to interpolate
+    @param fraction of the way from that sample to the next
     */
-    float getSplineOut(float currentIndex)
+    static float getSplineOut(const float* table, int n0, float alpha) noexcept
     {
-        const int n0 = floor(currentIndex);
-        const int n1 = (n0 + 1) % tableSize;
-        const int n2 = (n0 + 2) % tableSize;
-        const float alpha = currentIndex - n0;
+        const int n1 = n0 + 1;
+        const int n2 = n0 + 2;
 
-        auto* table = wavetable.getReadPointer(0);
         const float a = table[n1];
         const float c = ((3.0f * (table[n2] - table[n1])) - (3.0f * (table[n1] - table[n0]))) * 0.25f;
         const float b = (table[n2] - table[n1]) - (2.0f * c * 0.33333f);
@@ -102,12 +253,285 @@ public:
     }
 
 private:
-    /// The stored wavetable
-    juce::AudioBuffer<float> wavetable;
-    
-    /// The size of the wavetable in samples
-    const int tableSize;
-    
-    // Current index and table (/phase) delta
+    //--------------------------------------------------------------------------
+    /// Change the length of the table being read, choosing the phase mode and setting the phase to a fraction of a cycle
+    void setTableSize(int newTableSize, double normalisedPhase) noexcept
+    {
+        jassert(newTableSize > 1);
+
+        tableSize = newTableSize;
+        fixedPointPhase = juce::isPowerOfTwo(tableSize);
+
+        if (fixedPointPhase)
+        {
+            // a table of 2^n samples takes the top n bits of the phase as its index
+            indexShift = 32 - juce::findHighestSetBit((juce::uint32)tableSize);
+            fractionMask = (1u << indexShift) - 1u;
+            fractionScale = 1.0f / (float)(fractionMask + 1u);
+            phase = (juce::uint32)(juce::int64)(normalisedPhase * 4294967296.0);
+        }
+        else
+        {
+            currentIndex = (float)(normalisedPhase * tableSize);
+        }
+
+        updateDeltas();
+    }
+
+    /// How far through a cycle the oscillator currently is, between 0 and 1
+    double getNormalisedPhase() const noexcept
+    {
+        if (fixedPointPhase)
+            return (double)phase / 4294967296.0;
+
+        return (double)currentIndex / (double)tableSize;
+    }
+
+    /// Work out the per sample increment for whichever phase mode is in use
+    void updateDeltas() noexcept
+    {
+        tableDelta = (float)(cyclesPerSample * tableSize);
+        phaseDelta = (juce::uint32)(juce::int64)(cyclesPerSample * 4294967296.0);
+    }
+
+    //--------------------------------------------------------------------------
+    /// Block renderer for power of two tables, returns the first sample it didn't render
+    int renderFixedPointPhase(float* dest, int sample, int numSamples) noexcept
+    {
+       #if WAVETABLE_OSCILLATOR_AVX2
+        {
+            const __m256i laneOffsets = _mm256_setr_epi32(0, (int)phaseDelta, (int)(phaseDelta * 2u), (int)(phaseDelta * 3u),
+                                                          (int)(phaseDelta * 4u), (int)(phaseDelta * 5u), (int)(phaseDelta * 6u), (int)(phaseDelta * 7u));
+            const __m128i shift = _mm_cvtsi32_si128(indexShift);
+            const __m256i mask = _mm256_set1_epi32((int)fractionMask);
+            const __m256 scale = _mm256_set1_ps(fractionScale);
+
+            for (; sample + 8 <= numSamples; sample += 8)
+            {
+                const __m256i lanePhase = _mm256_add_epi32(_mm256_set1_epi32((int)phase), laneOffsets);
+                const __m256i n0 = _mm256_srl_epi32(lanePhase, shift);
+                const __m256 alpha = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(lanePhase, mask)), scale);
+
+                const __m256 y0 = _mm256_i32gather_ps(wavetable, n0, 4);
+                const __m256 y1 = _mm256_i32gather_ps(wavetable + 1, n0, 4);
+                const __m256 y2 = _mm256_i32gather_ps(wavetable + 2, n0, 4);
+
+                _mm256_storeu_ps(dest + sample, splineAVX(y0, y1, y2, alpha));
+
+                phase += phaseDelta * 8u;
+            }
+        }
+       #endif
+
+       #if WAVETABLE_OSCILLATOR_SSE
+        {
+            const __m128i laneOffsets = _mm_setr_epi32(0, (int)phaseDelta, (int)(phaseDelta * 2u), (int)(phaseDelta * 3u));
+            const __m128i shift = _mm_cvtsi32_si128(indexShift);
+            const __m128i mask = _mm_set1_epi32((int)fractionMask);
+            const __m128 scale = _mm_set1_ps(fractionScale);
+
+            for (; sample + 4 <= numSamples; sample += 4)
+            {
+                const __m128i lanePhase = _mm_add_epi32(_mm_set1_epi32((int)phase), laneOffsets);
+                const __m128 alpha = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(lanePhase, mask)), scale);
+
+                alignas(16) int n0[4];
+                _mm_store_si128((__m128i*)n0, _mm_srl_epi32(lanePhase, shift));
+
+                _mm_storeu_ps(dest + sample, splineSSE(gatherSSE(n0, 0), gatherSSE(n0, 1), gatherSSE(n0, 2), alpha));
+
+                phase += phaseDelta * 4u;
+            }
+        }
+       #elif WAVETABLE_OSCILLATOR_NEON
+        {
+            // loaded from memory, MSVC doesn't accept vector literals
+            const juce::uint32 laneDeltas[4] = { 0u, phaseDelta, phaseDelta * 2u, phaseDelta * 3u };
+            const uint32x4_t laneOffsets = vld1q_u32(laneDeltas);
+            const int32x4_t shift = vdupq_n_s32(-indexShift);
+            const uint32x4_t mask = vdupq_n_u32(fractionMask);
+
+            for (; sample + 4 <= numSamples; sample += 4)
+            {
+                const uint32x4_t lanePhase = vaddq_u32(vdupq_n_u32(phase), laneOffsets);
+                const float32x4_t alpha = vmulq_n_f32(vcvtq_f32_u32(vandq_u32(lanePhase, mask)), fractionScale);
+
+                int n0[4];
+                vst1q_s32(n0, vreinterpretq_s32_u32(vshlq_u32(lanePhase, shift)));
+
+                vst1q_f32(dest + sample, splineNEON(gatherNEON(n0, 0), gatherNEON(n0, 1), gatherNEON(n0, 2), alpha));
+
+                phase += phaseDelta * 4u;
+            }
+        }
+       #endif
+
+        return sample;
+    }
+
+    /// Block renderer for any other table length, returns the first sample it didn't render
+    int renderFloatIndex(float* dest, int sample, int numSamples) noexcept
+    {
+        const float tableLength = (float)tableSize;
+
+       #if WAVETABLE_OSCILLATOR_AVX2
+        // the lanes are only wrapped once, so very high notes that could wrap twice take the per sample path
+        if (tableDelta * 8.0f < tableLength)
+        {
+            const __m256 laneOffsets = _mm256_mul_ps(_mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f), _mm256_set1_ps(tableDelta));
+            const __m256 length = _mm256_set1_ps(tableLength);
+
+            for (; sample + 8 <= numSamples; sample += 8)
+            {
+                __m256 position = _mm256_add_ps(_mm256_set1_ps(currentIndex), laneOffsets);
+                position = _mm256_sub_ps(position, _mm256_and_ps(_mm256_cmp_ps(position, length, _CMP_GE_OQ), length));
+
+                const __m256i n0 = _mm256_cvttps_epi32(position);
+                const __m256 alpha = _mm256_sub_ps(position, _mm256_cvtepi32_ps(n0));
+
+                const __m256 y0 = _mm256_i32gather_ps(wavetable, n0, 4);
+                const __m256 y1 = _mm256_i32gather_ps(wavetable + 1, n0, 4);
+                const __m256 y2 = _mm256_i32gather_ps(wavetable + 2, n0, 4);
+
+                _mm256_storeu_ps(dest + sample, splineAVX(y0, y1, y2, alpha));
+
+                advanceIndex(8.0f, tableLength);
+            }
+        }
+       #endif
+
+       #if WAVETABLE_OSCILLATOR_SSE
+        if (tableDelta * 4.0f < tableLength)
+        {
+            const __m128 laneOffsets = _mm_mul_ps(_mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f), _mm_set1_ps(tableDelta));
+            const __m128 length = _mm_set1_ps(tableLength);
+
+            for (; sample + 4 <= numSamples; sample += 4)
+            {
+                __m128 position = _mm_add_ps(_mm_set1_ps(currentIndex), laneOffsets);
+                position = _mm_sub_ps(position, _mm_and_ps(_mm_cmpge_ps(position, length), length));
+
+                const __m128i indices = _mm_cvttps_epi32(position);
+                const __m128 alpha = _mm_sub_ps(position, _mm_cvtepi32_ps(indices));
+
+                alignas(16) int n0[4];
+                _mm_store_si128((__m128i*)n0, indices);
+
+                _mm_storeu_ps(dest + sample, splineSSE(gatherSSE(n0, 0), gatherSSE(n0, 1), gatherSSE(n0, 2), alpha));
+
+                advanceIndex(4.0f, tableLength);
+            }
+        }
+       #elif WAVETABLE_OSCILLATOR_NEON
+        if (tableDelta * 4.0f < tableLength)
+        {
+            // loaded from memory, MSVC doesn't accept vector literals
+            static const float laneIndices[4] = { 0.0f, 1.0f, 2.0f, 3.0f };
+            const float32x4_t laneOffsets = vmulq_n_f32(vld1q_f32(laneIndices), tableDelta);
+            const float32x4_t length = vdupq_n_f32(tableLength);
+
+            for (; sample + 4 <= numSamples; sample += 4)
+            {
+                float32x4_t position = vaddq_f32(vdupq_n_f32(currentIndex), laneOffsets);
+                position = vsubq_f32(position, vreinterpretq_f32_u32(vandq_u32(vcgeq_f32(position, length), vreinterpretq_u32_f32(length))));
+
+                const int32x4_t indices = vcvtq_s32_f32(position);
+                const float32x4_t alpha = vsubq_f32(position, vcvtq_f32_s32(indices));
+
+                int n0[4];
+                vst1q_s32(n0, indices);
+
+                vst1q_f32(dest + sample, splineNEON(gatherNEON(n0, 0), gatherNEON(n0, 1), gatherNEON(n0, 2), alpha));
+
+                advanceIndex(4.0f, tableLength);
+            }
+        }
+       #else
+        juce::ignoreUnused(dest, numSamples, tableLength);
+       #endif
+
+        return sample;
+    }
+
+    /// Move the floating point index on by a register's worth of samples, only ever needs one wrap
+    forcedinline void advanceIndex(float numLanes, float tableLength) noexcept
+    {
+        currentIndex += tableDelta * numLanes;
+        currentIndex -= currentIndex >= tableLength ? tableLength : 0.0f;
+    }
+
+    // load the sample at an offset from each lane's index, and the same spline as getSplineOut for every lane at once
+   #if WAVETABLE_OSCILLATOR_AVX2
+    static forcedinline __m256 splineAVX(__m256 y0, __m256 y1, __m256 y2, __m256 alpha) noexcept
+    {
+        const __m256 y2MinusY1 = _mm256_sub_ps(y2, y1);
+        const __m256 c = _mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(y2MinusY1, _mm256_set1_ps(3.0f)), _mm256_mul_ps(_mm256_sub_ps(y1, y0), _mm256_set1_ps(3.0f))), _mm256_set1_ps(0.25f));
+        const __m256 b = _mm256_sub_ps(y2MinusY1, _mm256_mul_ps(c, _mm256_set1_ps(2.0f * 0.33333f)));
+        const __m256 d = _mm256_mul_ps(c, _mm256_set1_ps(-0.33333f));
+        return _mm256_add_ps(y1, _mm256_mul_ps(alpha, _mm256_add_ps(b, _mm256_mul_ps(alpha, _mm256_add_ps(c, _mm256_mul_ps(alpha, d))))));
+    }
+   #endif
+
+   #if WAVETABLE_OSCILLATOR_SSE
+    forcedinline __m128 gatherSSE(const int* n0, int offset) const noexcept
+    {
+        return _mm_setr_ps(wavetable[n0[0] + offset], wavetable[n0[1] + offset], wavetable[n0[2] + offset], wavetable[n0[3] + offset]);
+    }
+
+    static forcedinline __m128 splineSSE(__m128 y0, __m128 y1, __m128 y2, __m128 alpha) noexcept
+    {
+        const __m128 y2MinusY1 = _mm_sub_ps(y2, y1);
+        const __m128 c = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(y2MinusY1, _mm_set1_ps(3.0f)), _mm_mul_ps(_mm_sub_ps(y1, y0), _mm_set1_ps(3.0f))), _mm_set1_ps(0.25f));
+        const __m128 b = _mm_sub_ps(y2MinusY1, _mm_mul_ps(c, _mm_set1_ps(2.0f * 0.33333f)));
+        const __m128 d = _mm_mul_ps(c, _mm_set1_ps(-0.33333f));
+        return _mm_add_ps(y1, _mm_mul_ps(alpha, _mm_add_ps(b, _mm_mul_ps(alpha, _mm_add_ps(c, _mm_mul_ps(alpha, d))))));
+    }
+   #elif WAVETABLE_OSCILLATOR_NEON
+    forcedinline float32x4_t gatherNEON(const int* n0, int offset) const noexcept
+    {
+        const float samples[4] = { wavetable[n0[0] + offset], wavetable[n0[1] + offset], wavetable[n0[2] + offset], wavetable[n0[3] + offset] };
+        return vld1q_f32(samples);
+    }
+
+    static forcedinline float32x4_t splineNEON(float32x4_t y0, float32x4_t y1, float32x4_t y2, float32x4_t alpha) noexcept
+    {
+        const float32x4_t y2MinusY1 = vsubq_f32(y2, y1);
+        const float32x4_t c = vmulq_n_f32(vsubq_f32(vmulq_n_f32(y2MinusY1, 3.0f), vmulq_n_f32(vsubq_f32(y1, y0), 3.0f)), 0.25f);
+        const float32x4_t b = vsubq_f32(y2MinusY1, vmulq_n_f32(c, 2.0f * 0.33333f));
+        const float32x4_t d = vmulq_n_f32(c, -0.33333f);
+        return vaddq_f32(y1, vmulq_f32(alpha, vaddq_f32(b, vmulq_f32(alpha, vaddq_f32(c, vmulq_f32(alpha, d))))));
+    }
+   #endif
+
+    //--------------------------------------------------------------------------
+    /// The wavetable being played, owned elsewhere
+    const float* wavetable = nullptr;
+
+    /// The wavetable being crossfaded out of after a swap
+    const float* previousWavetable = nullptr;
+
+    /// The size of the wavetable in samples, not including the guard samples
+    int tableSize = 0;
+
+    /// Length and remaining samples of the crossfade after a wavetable swap
+    int crossfadeLength = 0, crossfadeRemaining = 0;
+
+    /// Frequency of playback as a fraction of the sample rate
+    double cyclesPerSample = 0.0;
+
+    /// Whether the wavetable is a power of two long and the fixed point phase is used
+    bool fixedPointPhase = false;
+
+    // Current index and table (/phase) delta, used for tables that aren't a power of two
     float currentIndex = 0.0f, tableDelta = 0.0f;
-};
\ No newline at end of file
+
+    // Fixed point phase and phase delta, a whole cycle is 2^32 so it wraps by overflowing
+    juce::uint32 phase = 0, phaseDelta = 0;
+
+    /// How far the phase is shifted down to get the index
+    int indexShift = 0;
+
+    /// Bits of the phase below the index, and what scales them to a fraction between 0 and 1
+    juce::uint32 fractionMask = 0;
+    float fractionScale = 0.0f;
+};
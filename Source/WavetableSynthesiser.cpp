@@ -13,31 +13,28 @@
 #include "WavetableSynthesiser.h"
 #include <JuceHeader.h>
 
-WavetableSynthVoice::WavetableSynthVoice() :
-    slotOne(getSampleRate()),
-    slotTwo(getSampleRate()),
-    slotThree(getSampleRate()),
-    slotFour(getSampleRate()),
-    slotFive(getSampleRate())
-
-
+WavetableSynthVoice::WavetableSynthVoice()
 {
-    // set sample rate of ADSR envelope
-    env.setSampleRate(getSampleRate());
-    
+    // the envelopes live in the voice bank, which gets the sample rate when the synthesiser is prepared
+
+    // no parameters have been applied yet
+    std::fill(std::begin(appliedChangeCounts), std::end(appliedChangeCounts), ~0u);
 }
 
-void WavetableSynthVoice::startNote(int midiNoteNumber, float velocity, juce::SynthesiserSound*, int /*currentPitchWheelPosition*/)
+void WavetableSynthVoice::startNote(int midiNoteNumber, float velocity, juce::SynthesiserSound*, int currentPitchWheelPosition)
 {
     // change the current playing state of the voice
     playing = true;
-    ending = false;
 
-    // store frequency in Hz from the midi note number
-    float freq = juce::MidiMessage::getMidiNoteInHertz(midiNoteNumber);
+    // store frequency in Hz from the midi note number, bent by wherever the pitch wheel already is
+    noteFrequency = (float)juce::MidiMessage::getMidiNoteInHertz(midiNoteNumber);
+    pitchWheelPosition = currentPitchWheelPosition;
+    pitchWheelChanged = false;
+
+    const float freq = getBentFrequency();
 
     // variable for selecting the current wavetable dependent on required frequency
-    int currentWavetable = 0;
+    currentWavetable = 0;
 
     // find which wavetable to use, starting at midi note number 19 and incrementing per octave
     while (midiNoteNumber >= (19 + 12 * currentWavetable))
@@ -45,293 +42,943 @@ void WavetableSynthVoice::startNote(int midiNoteNumber, float velocity, juce::Sy
         currentWavetable++;
     }
 
-    // clear what the wavetables stored in the OwnedArray's
-    wtOscillatorOne.clear();
-    wtOscillatorTwo.clear();
-    wtOscillatorThree.clear();
-    wtOscillatorFour.clear();
-    wtOscillatorFive.clear();
-
-    // creating a new WavetableOscillator class from the the AudioSampleBuffer
-    auto* oscillatorSlotOne = new WavetableOscillator(slotOne.getAntialiasedWavetable(currentWavetable));
-    auto* oscillatorSlotTwo = new WavetableOscillator(slotTwo.getAntialiasedWavetable(currentWavetable));
-    auto* oscillatorSlotThree = new WavetableOscillator(slotThree.getAntialiasedWavetable(currentWavetable));
-    auto* oscillatorSlotFour = new WavetableOscillator(slotFour.getAntialiasedWavetable(currentWavetable));
-    auto* oscillatorSlotFive = new WavetableOscillator(slotFive.getAntialiasedWavetable(currentWavetable));
-
-    // setting the frequency and sample rate in this class instance
-    oscillatorSlotOne->setFrequency(freq, getSampleRate());
-    oscillatorSlotTwo->setFrequency(freq, getSampleRate());
-    oscillatorSlotThree->setFrequency(freq, getSampleRate());
-    oscillatorSlotFour->setFrequency(freq, getSampleRate());
-    oscillatorSlotFive->setFrequency(freq, getSampleRate());
-
-    // adding to the wavetable OwnedArrays in private variables
-    wtOscillatorOne.add(oscillatorSlotOne);
-    wtOscillatorTwo.add(oscillatorSlotTwo);
-    wtOscillatorThree.add(oscillatorSlotThree);
-    wtOscillatorFour.add(oscillatorSlotFour);
-    wtOscillatorFive.add(oscillatorSlotFive);
-
-    // set the frequency for the fundamental oscillator
-    fundamentalOsc.setFrequency(freq);
-
-    // reset and start envelope
-    env.reset();
-    env.noteOn();
-
-    filterEnv.reset();
-    filterEnv.noteOn();
+    // the top octave covers every note above it
+    currentWavetable = juce::jmin(currentWavetable, WavescanningSlot::numWavetableOctaves - 1);
+
+    // any crossfade from a previous slot change no longer matters, and the morph oscillator needs syncing to the new note
+    previousTables = nullptr;
+    tableCrossfadeRemaining = 0;
+    playingMorphTable = nullptr;
+
+    // point each slot's oscillator at the octave of its wavetable and set its frequency, no copying or allocation
+    for (int slot = 0; slot < WavescanTables::numSlots; slot++)
+    {
+        wtOscillators[slot].reset(currentTables->slots[slot]->getAntialiasedWavetable(currentWavetable));
+        wtOscillators[slot].setFrequency(freq, getSampleRate());
+    }
+
+    // the voice's own lfo starts from the beginning of its cycle on every note, the global lfo keeps running
+    lfo.setPhase(0.0f);
+
+    // restart the envelopes and set the frequency for the fundamental oscillator
+    voiceBank->noteOn(bankIndex, freq);
 }
 
 void WavetableSynthVoice::stopNote(float /*velocity*/, bool allowTailOff)
 {
-    env.noteOff();
-    filterEnv.noteOff();
-    ending = true;
+    voiceBank->noteOff(bankIndex);
 }
 
 void WavetableSynthVoice::prepareToPlay(double sampleRate, int samplesPerBlock, int outputChannels)
 {
-    // reset filter before beginning
-    ladderFilter.reset();
+    // the voice is rendered in mono into its channel of the filter bank and only spread across the output channels
+    // when it is added to them, the filter bank and the scratch buffer are prepared by the synthesiser
+    juce::ignoreUnused(samplesPerBlock, outputChannels);
 
-    // further setting up required for juce DSP filter
-    juce::dsp::ProcessSpec spec;
-    spec.maximumBlockSize = samplesPerBlock;
-    spec.sampleRate = sampleRate;
-    spec.numChannels = outputChannels;
-    ladderFilter.prepare(spec);
+    // set sample rate for the LFO
+    lfo.setSampleRate(sampleRate);
+}
 
-    // setting size of voice buffer that will be used for applying filters to individual voices
-    voiceBuffer.setSize(outputChannels, samplesPerBlock);
 
-    // set sample rates for all the LFO shapes
-    lfo1.setSampleRate(sampleRate);
-    lfo2.setSampleRate(sampleRate); 
-    lfo3.setSampleRate(sampleRate);
-    lfo4.setSampleRate(sampleRate);
+void WavetableSynthVoice::renderNextBlock(juce::AudioSampleBuffer& outputBuffer, int startSample, int numSamples)
+{
+    jassert(filterBank != nullptr && voiceBank != nullptr && scratchBuffer != nullptr);
 
-    // set sample rate for the fundamental oscillator 
-    fundamentalOsc.setSampleRate(sampleRate);
+    // retune once for however many pitch wheel events arrived since the last block
+    if (playing && pitchWheelChanged)
+    {
+        const float freq = getBentFrequency();
 
-}
+        for (auto& oscillator : wtOscillators)
+            oscillator.setFrequency(freq, (float)getSampleRate());
 
+        morphOscillator.setFrequency(freq, (float)getSampleRate());
+        voiceBank->setFrequency(bankIndex, freq);
 
-void WavetableSynthVoice::renderNextBlock(juce::AudioSampleBuffer& outputBuffer, int startSample, int numSamples)
-{
-    
+        pitchWheelChanged = false;
+    }
+
+    // only mix, filter and add this voice if it is playing at the start of the block
+    renderedThisBlock = playing;
+    filterBank->setVoiceActive(bankIndex, playing);
 
     if (playing) // check to see if this voice should be playing
     {
-        jassert(numSamples <= voiceBuffer.getNumSamples());
-        
-        // creating a proxy audio buffer to apply Juce DSP filter to before adding to output buffer
-        juce::AudioBuffer<float> proxy(voiceBuffer.getArrayOfWritePointers(), voiceBuffer.getNumChannels(), startSample, numSamples);
-        proxy.clear();
+        // the voice's samples are written to its channel of the filter bank, enveloped and mixed by the voice bank,
+        // filtered along with the other voices and then added to the output buffer in addFilteredBlock
+        auto* voiceSamples = filterBank->getVoiceChannel(bankIndex) + startSample;
+
+        auto* wavescanPositions = scratchBuffer->getWritePointer(WavescanTables::numSlots);
+
+        // fill the block with the lfo, then scale and offset it into the wavescan position, brickwalled so it doesn't exceed bounds
+        if (globalLfoSamples != nullptr)
+            juce::FloatVectorOperations::copy(wavescanPositions, globalLfoSamples + startSample, numSamples);
+        else
+            lfo.process(wavescanPositions, numSamples);
 
+        juce::FloatVectorOperations::multiply(wavescanPositions, lfoAmp, numSamples);
 
-        // iterate through the necessary number of samples (from startSample up to startSample + numSamples)
-        for (int sample = 0; sample < proxy.getNumSamples(); sample++)
+        if (wavescanRamp != nullptr)
+            juce::FloatVectorOperations::add(wavescanPositions, wavescanRamp + startSample, numSamples);
+        else
+            juce::FloatVectorOperations::add(wavescanPositions, wavescanBal, numSamples);
+
+        // the mod wheel scans up from there
+        if (modWheel > 0.0f)
+            juce::FloatVectorOperations::add(wavescanPositions, modWheel * 4.0f, numSamples);
+
+        juce::FloatVectorOperations::clip(wavescanPositions, wavescanPositions, 0.0f, 4.0f, numSamples);
+
+        // lowest and highest wavescan position reached during this block, so we know which slots it passes through
+        const auto wavescanRange = juce::FloatVectorOperations::findMinAndMax(wavescanPositions, numSamples);
+        const float lowestWavescanPosition = wavescanRange.getStart();
+        const float highestWavescanPosition = wavescanRange.getEnd();
+
+        // samples of the baked morph table, or null when morphing between the slots live
+        const float* morphSamples = nullptr;
+
+        if (canPlayMorphTable())
         {
-            // get next sample from the amplitude and filter ADSR envelopes
-            float envVal = env.getNextSample();
-            filterEnvVal = filterEnv.getNextSample();
-
-            // creating a float taken from index 0 of the wtOscillators array
-            auto* oscillatorSlotOne = wtOscillatorOne.getUnchecked(0);
-            auto* oscillatorSlotTwo = wtOscillatorTwo.getUnchecked(0);
-            auto* oscillatorSlotThree = wtOscillatorThree.getUnchecked(0);
-            auto* oscillatorSlotFour = wtOscillatorFour.getUnchecked(0);
-            auto* oscillatorSlotFive = wtOscillatorFive.getUnchecked(0);
-
-            // getting the current sample from the oscillator slots and storing in sample variable
-            auto slotOneSample = oscillatorSlotOne->getNextSample();
-            auto slotTwoSample = oscillatorSlotTwo->getNextSample();
-            auto slotThreeSample = oscillatorSlotThree->getNextSample();
-            auto slotFourSample = oscillatorSlotFour->getNextSample();
-            auto slotFiveSample = oscillatorSlotFive->getNextSample();
-
-            // switch statement for determining which lfo shape to use and get the next sample of
-            switch (lfoShape) {
-            case 1:
-                lfoSample = lfo1.process();
-                break;
-            case 2:
-                lfoSample = lfo2.process();
-                break;
-            case 3:
-                lfoSample = lfo3.process();
-                break;
-            case 4:
-                lfoSample = lfo4.process();
-                break;
-            }
-            
-            // find current wavescan parameter including modulation by lfo
-            float modulatedWavescanBal = wavescanBal + (lfoSample * lfoAmp);
-
-            // brickwalling the modulated wavescanning parameter so it doesn't exceed bounds
-            if (modulatedWavescanBal < 0.0f)
-                modulatedWavescanBal = 0.0f;
-            else if (modulatedWavescanBal > 4.0f)
-                modulatedWavescanBal = 4.0f;
-
-            // if, else if statement used for finding which two slots its currently between
-            // and then mixes between the two
-            if (modulatedWavescanBal <= 1.0)
-            {
-                currentSample = ((slotOneSample * (1 - modulatedWavescanBal)) + (slotTwoSample * modulatedWavescanBal)) * gain * envVal;
-            }
-            else if (wavescanBal <= 2.0)
+            // start the morph oscillator off in phase with the slots, so swapping over is seamless
+            if (playingMorphTable != availableMorphTable)
             {
-                float normalizedWavescanVal = modulatedWavescanBal - 1.0f;
-                currentSample = ((slotTwoSample * (1 - normalizedWavescanVal)) + (slotThreeSample * normalizedWavescanVal)) * gain * envVal;
+                morphOscillator = wtOscillators[0];
+                morphOscillator.setWavetable(availableMorphTable->octaves[currentWavetable], 0);
+                playingMorphTable = availableMorphTable;
             }
-            else if (wavescanBal <= 3.0)
+
+            // a single oscillator read per sample, the slots just keep their phase up to date
+            auto* morphBuffer = scratchBuffer->getWritePointer(WavescanTables::numSlots + 1);
+            morphOscillator.renderBlock(morphBuffer, numSamples);
+            morphSamples = morphBuffer;
+
+            for (int slot = 0; slot < WavescanTables::numSlots; slot++)
+                wtOscillators[slot].skip(numSamples);
+        }
+        else
+        {
+            // the morph oscillator has stopped following the slots, so it will need syncing again
+            playingMorphTable = nullptr;
+
+            // only the slots either side of the positions reached are rendered, usually just two of them
+            const int firstSlot = getLowerSlot(lowestWavescanPosition);
+            const int lastSlot = getLowerSlot(highestWavescanPosition) + 1;
+
+            for (int slot = 0; slot < WavescanTables::numSlots; slot++)
             {
-                float normalizedWavescanVal = modulatedWavescanBal - 2.0f;
-                currentSample = ((slotThreeSample * (1 - normalizedWavescanVal)) + (slotFourSample * normalizedWavescanVal)) * gain * envVal;
+                // slots that aren't heard still move their phase on, so they come back in without a click
+                if (slot >= firstSlot && slot <= lastSlot)
+                    wtOscillators[slot].renderBlock(scratchBuffer->getWritePointer(slot), numSamples);
+                else
+                    wtOscillators[slot].skip(numSamples);
             }
-            else if (wavescanBal <= 4.0)
+        }
+
+        if (morphSamples != nullptr)
+        {
+            // the blend has already been baked into the morph table
+            juce::FloatVectorOperations::copyWithMultiply(voiceSamples, morphSamples, gain, numSamples);
+        }
+        else
+        {
+            // iterate through the necessary number of samples (from startSample up to startSample + numSamples)
+            for (int sample = 0; sample < numSamples; sample++)
             {
-                float normalizedWavescanVal = modulatedWavescanBal - 3.0f;
-                currentSample = ((slotFourSample * (1 - normalizedWavescanVal)) + (slotFiveSample * normalizedWavescanVal)) * gain * envVal;
+                // find which two slots its currently between and then mix between the two
+                const float modulatedWavescanBal = wavescanPositions[sample];
+                const int lowerSlot = getLowerSlot(modulatedWavescanBal);
+                const float normalizedWavescanVal = modulatedWavescanBal - (float)lowerSlot;
+
+                const float lowerSlotSample = scratchBuffer->getSample(lowerSlot, sample);
+                const float upperSlotSample = scratchBuffer->getSample(lowerSlot + 1, sample);
+
+                voiceSamples[sample] = ((lowerSlotSample * (1 - normalizedWavescanVal)) + (upperSlotSample * normalizedWavescanVal)) * gain;
             }
+        }
+
+        // let go of the old wavetables once the oscillators have faded out of them
+        if (tableCrossfadeRemaining > 0)
+        {
+            tableCrossfadeRemaining -= numSamples;
+
+            if (tableCrossfadeRemaining <= 0)
+                previousTables = nullptr;
+        }
+    }
+}
+
+void WavetableSynthVoice::addFilteredBlock(juce::AudioSampleBuffer& outputBuffer, int startSample, int numSamples)
+{
+    if (!renderedThisBlock)
+        return;
+
+    const auto* voiceSamples = filterBank->getVoiceChannel(bankIndex) + startSample;
+
+    // add the mono voice to each output channel at its pan gain, a stereo bus is spread, anything else gets the voice as is
+    for (int channel = 0; channel < outputBuffer.getNumChannels(); channel++)
+    {
+        const float channelGain = outputBuffer.getNumChannels() == 2 ? panGains[channel] : 1.0f;
+        juce::FloatVectorOperations::addWithMultiply(outputBuffer.getWritePointer(channel, startSample), voiceSamples, channelGain, numSamples);
+    }
+}
+
+void WavetableSynthVoice::updateFilter(float smoothedCutoff, float smoothedResonance)
+{
+    if (!renderedThisBlock)
+        return;
+
+    calculateFilterParameters(smoothedCutoff, smoothedResonance);
+
+    // update this voice's lane of the filter bank with the parameter values plus the envelope modulation
+    filterBank->setCutoffFrequencyHz(bankIndex, currentCutOff);
+    filterBank->setResonance(bankIndex, currentResonance);
+}
+
+void WavetableSynthVoice::startFilter(float smoothedCutoff, float smoothedResonance)
+{
+    // the filter envelope has just restarted, so this is where it starts from
+    calculateFilterParameters(smoothedCutoff, smoothedResonance);
+
+    // no ramp from wherever the voice's last note left its filter
+    filterBank->jumpToParameters(bankIndex, currentCutOff, currentResonance);
+}
+
+void WavetableSynthVoice::calculateFilterParameters(float smoothedCutoff, float smoothedResonance)
+{
+    // current value of the filter ADSR envelope
+    filterEnvVal = voiceBank->getFilterEnvelope(bankIndex);
+
+    // calculate cutoff frequency and resonance values with current modulation amount 
+    if (filterCutoffAmp >= 0.0f)
+        currentCutOff = smoothedCutoff + filterEnvVal * filterCutoffAmp* (20000.0f - smoothedCutoff);
+    else if (filterCutoffAmp < 0.0f)
+        currentCutOff = smoothedCutoff + filterEnvVal * filterCutoffAmp * (smoothedCutoff - 100.0f);
+
+    if (filterResonanceAmp >= 0.0f)
+        currentResonance = smoothedResonance + (filterEnvVal * filterResonanceAmp * (1.0f - smoothedResonance));
+    else if (filterResonanceAmp < 0.0f)
+        currentResonance = smoothedResonance + (filterEnvVal * filterResonanceAmp * smoothedResonance);
+}
+
+void WavetableSynthVoice::finishBlock()
+{
+    if (!renderedThisBlock)
+        return;
+
+    // clear current note if it has been released and the envelope has died away
+    if (playing && voiceBank->isFinished(bankIndex))
+    {
+        clearCurrentNote();
+        playing = false;
+    }
+}
+
+void WavetableSynthVoice::setBanks(LadderFilterBank* _filterBank, VoiceBank* _voiceBank, int index)
+{
+    filterBank = _filterBank;
+    voiceBank = _voiceBank;
+    bankIndex = index;
+
+    // step through the stereo field by the golden ratio, so however many voices are playing they are spread evenly
+    panPosition = 2.0f * std::fmod(0.5f + (float)index * 0.618034f, 1.0f) - 1.0f;
+
+    // the banks have just been prepared, so every parameter needs applying again
+    std::fill(std::begin(appliedChangeCounts), std::end(appliedChangeCounts), ~0u);
+}
+
+void WavetableSynthVoice::setScratchBuffer(juce::AudioBuffer<float>* _scratchBuffer)
+{
+    scratchBuffer = _scratchBuffer;
+}
+
+bool WavetableSynthVoice::canPlayMorphTable() const noexcept
+{
+    // only while the morph table was made from the slots and position this voice is playing, with nothing modulating them
+    return availableMorphTable != nullptr
+        && availableMorphTable->tables == currentTables.get()
+        && availableMorphTable->wavescanPosition == juce::jlimit(0.0f, 4.0f, wavescanBal)
+        && wavescanRamp == nullptr
+        && modWheel == 0.0f
+        && lfoAmp == 0.0f
+        && tableCrossfadeRemaining <= 0;
+}
+
+float WavetableSynthVoice::getBentFrequency() const noexcept
+{
+    const float semitones = (float)(pitchWheelPosition - 8192) / 8192.0f * pitchBendRange;
+    return noteFrequency * std::exp2(semitones / 12.0f);
+}
+
+void WavetableSynthVoice::pitchWheelMoved(int newPitchWheelValue)
+{
+    pitchWheelPosition = newPitchWheelValue;
+    pitchWheelChanged = true;
+}
+
+void WavetableSynthVoice::controllerMoved(int controllerNumber, int newControllerValue)
+{
+    if (controllerNumber == 1)
+        modWheel = (float)newControllerValue / 127.0f;
+}
+
+int WavetableSynthVoice::getLowerSlot(float wavescanPosition) const noexcept
+{
+    // the last slot is only ever the upper of a pair
+    return juce::jlimit(0, WavescanTables::numSlots - 2, (int)wavescanPosition);
+}
+
+//===========================================================================
+// PARAMETERS
+
+void WavetableSynthVoice::setParameters(const VoiceParameters& parameters)
+{
+    // these change with every block or are just pointers, so are always taken
+    setWavescanTables(parameters.tables);
+    availableMorphTable = parameters.morphTable;
+    globalLfoSamples = parameters.globalLfoSamples;
+
+    wavescanBal = parameters.wavescan;
+    wavescanRamp = parameters.wavescanRamp;
+
+    // everything else is only worked out again when its group has changed since this voice last saw it
+    auto hasChanged = [&](VoiceParameters::Group group)
+    {
+        if (appliedChangeCounts[group] == parameters.changeCounts[group])
+            return false;
+
+        appliedChangeCounts[group] = parameters.changeCounts[group];
+        return true;
+    };
+
+    if (hasChanged(VoiceParameters::mixerGroup))
+    {
+        wavetableVolume = parameters.wavetableVolume;
+        sineVolume = parameters.sineVolume;
+        voiceBank->setVolumes(bankIndex, wavetableVolume, sineVolume);
+
+        setPan(parameters.stereoSpread * panPosition);
+    }
+
+    if (hasChanged(VoiceParameters::envelopeGroup))
+    {
+        envParams = parameters.envelope;
+        voiceBank->setAmplitudeEnvelope(bankIndex, envParams);
+    }
+
+    if (hasChanged(VoiceParameters::filterGroup))
+    {
+        filterCutoffAmp = parameters.filterCutoffAmp;
+        filterResonanceAmp = parameters.filterResonanceAmp;
+    }
+
+    if (hasChanged(VoiceParameters::filterEnvelopeGroup))
+    {
+        filterEnvParams = parameters.filterEnvelope;
+        voiceBank->setFilterEnvelope(bankIndex, filterEnvParams);
+    }
+
+    if (hasChanged(VoiceParameters::lfoGroup))
+    {
+        lfoAmp = parameters.lfoAmp;
+        lfo.setShape(parameters.lfoShape);
+        lfo.setFrequency(parameters.lfoFreq);
+    }
+}
+
+//=================================================================================
+
+void WavetableSynthVoice::setWavescanTables(WavescanTables* tables)
+{
+    if (tables == currentTables.get())
+        return;
+
+    // if a note is sounding, crossfade each changed slot from its old wavetable to the new one
+    if (playing && currentTables != nullptr)
+    {
+        for (int slot = 0; slot < WavescanTables::numSlots; slot++)
+        {
+            if (tables->slots[slot] != currentTables->slots[slot])
+                wtOscillators[slot].setWavetable(tables->slots[slot]->getAntialiasedWavetable(currentWavetable), tableCrossfadeSamples);
+        }
+
+        // keep the old wavetables alive until the crossfade has finished
+        previousTables = currentTables;
+        tableCrossfadeRemaining = tableCrossfadeSamples;
+    }
+
+    currentTables = tables;
+}
+
+void WavetableSynthVoice::setPan(float pan)
+{
+    // balance law, so a centred voice goes into both channels at full level just like before it could be panned
+    panGains[0] = juce::jmin(1.0f, 1.0f - pan);
+    panGains[1] = juce::jmin(1.0f, 1.0f + pan);
+}
+
+//=================================================================================
+// SYNTHESISER
+
+WavetableSynthesiser::WavetableSynthesiser()
+{
+    // nothing is playing and no note is mapped until voices are added and prepared
+    std::fill(std::begin(activeVoicePositions), std::end(activeVoicePositions), -1);
+    std::fill(std::begin(noteVoices), std::end(noteVoices), -1);
+    std::fill(std::begin(voiceNoteSlots), std::end(voiceNoteSlots), -1);
+}
+
+void WavetableSynthesiser::prepare(double sampleRate, int samplesPerBlock)
+{
+    jassert(getNumVoices() <= maxVoices);
+
+    setCurrentPlaybackSampleRate(sampleRate);
+
+    // one filter bank channel and one voice bank state per voice
+    filterBank.prepare(sampleRate, samplesPerBlock, getNumVoices());
+    voiceBank.prepare(sampleRate, getNumVoices());
+
+    // the filters ramp from one control point to the next, and the control points start again from here
+    filterBank.setSmoothingLength(controlRate);
+    samplesUntilControlPoint = controlRate;
+
+    // a worker thread for each spare core, only running while multi-core rendering is on
+    numWorkers = juce::jlimit(0, VoiceRenderPool::maxWorkers, juce::SystemStats::getNumPhysicalCpus() - 1);
+    renderPool.stop();
+
+    // one scratch buffer per rendering thread, rather than one per voice
+    scratchBuffers.clear();
+
+    for (int i = 0; i < numWorkers + 1; i++)
+        scratchBuffers.add(new juce::AudioBuffer<float>(WavetableSynthVoice::numScratchChannels, samplesPerBlock));
+
+    wavetableVoices.clearQuick();
+
+    for (int i = 0; i < getNumVoices(); i++)
+    {
+        WavetableSynthVoice* v = dynamic_cast<WavetableSynthVoice*>(getVoice(i));
+        v->setBanks(&filterBank, &voiceBank, i);
+        v->setScratchBuffer(scratchBuffers[0]);
+        wavetableVoices.add(v);
+    }
+
+    // start the workers now if they are wanted, then keep them in step with the setting
+    timerCallback();
+    startTimer(250);
+
+    // start the allocator again from scratch
+    const juce::ScopedLock sl(lock);
+
+    numActiveVoices = 0;
+    std::fill(std::begin(activeVoicePositions), std::end(activeVoicePositions), -1);
+    std::fill(std::begin(noteVoices), std::end(noteVoices), -1);
+    std::fill(std::begin(voiceNoteSlots), std::end(voiceNoteSlots), -1);
+
+    polyphony = juce::jlimit(1, juce::jmax(1, getNumVoices()), polyphony);
+    numFreeVoices = 0;
+
+    // pushed highest first, so the lowest voices are used first and the filter bank's groups stay full
+    for (int i = polyphony - 1; i >= 0; i--)
+        if (!wavetableVoices[i]->isVoiceActive())
+            freeVoices[numFreeVoices++] = i;
+
+    // the voice bank has been cleared under any voice still playing, so stop them and free them once they have rendered a block
+    for (int i = 0; i < getNumVoices(); i++)
+    {
+        if (wavetableVoices[i]->isVoiceActive())
+        {
+            activateVoice(i);
+            stopVoice(wavetableVoices[i], 0.0f, false);
+        }
+    }
+}
+
+void WavetableSynthesiser::setPolyphony(int newPolyphony)
+{
+    newPolyphony = juce::jlimit(1, juce::jmax(1, wavetableVoices.size()), newPolyphony);
+
+    if (newPolyphony == polyphony)
+        return;
+
+    const juce::ScopedLock sl(lock);
+
+    if (newPolyphony > polyphony)
+    {
+        // voices still fading out from before the polyphony was lowered are freed once they finish
+        for (int i = newPolyphony - 1; i >= polyphony; i--)
+            if (activeVoicePositions[i] < 0)
+                freeVoices[numFreeVoices++] = i;
+    }
+    else
+    {
+        // keep only the free voices within the new polyphony
+        int kept = 0;
+
+        for (int i = 0; i < numFreeVoices; i++)
+            if (freeVoices[i] < newPolyphony)
+                freeVoices[kept++] = freeVoices[i];
 
-            // get next sample of the basic sine wave fundamental oscillator
-            float fundamentalSample = fundamentalOsc.process() * envVal;
+        numFreeVoices = kept;
 
-            // for each channel, write the currentSample float to the output
-            for (int channel = 0; channel < proxy.getNumChannels(); channel++)
+        // and let the voices above it fade out, they aren't freed when they finish
+        for (int i = 0; i < numActiveVoices; i++)
+        {
+            const int voice = activeVoices[i];
+
+            if (voice >= newPolyphony && !voiceBank.isReleased(voice))
             {
-                // The output sample is scaled by 0.1 so that it is not too loud by default
-                proxy.addSample(channel, sample, ((currentSample * wavetableVolume) + (fundamentalSample * sineVolume)) * 0.5);
+                unmapNote(voice);
+                stopVoice(wavetableVoices[voice], 1.0f, true);
             }
+        }
+    }
+
+    polyphony = newPolyphony;
+}
+
+void WavetableSynthesiser::setMultiCoreRendering(bool shouldRenderOnWorkers)
+{
+    multiCoreRendering.store(shouldRenderOnWorkers, std::memory_order_relaxed);
+}
+
+void WavetableSynthesiser::timerCallback()
+{
+    // threads can't be started or stopped on the audio thread, so the setting is followed from here
+    const bool workersWanted = multiCoreRendering.load(std::memory_order_relaxed) && numWorkers > 0;
+
+    if (workersWanted && !renderPool.isRunning())
+        renderPool.start(numWorkers);
+    else if (!workersWanted && renderPool.isRunning())
+        renderPool.stop();
+}
+
+void WavetableSynthesiser::setControlRate(int numSamples)
+{
+    numSamples = juce::jmax(1, numSamples);
+
+    if (numSamples == controlRate)
+        return;
+
+    controlRate = numSamples;
+    filterBank.setSmoothingLength(controlRate);
+
+    // a shorter period starts straight away rather than waiting out the rest of the longer one
+    samplesUntilControlPoint = juce::jmin(samplesUntilControlPoint, controlRate);
+}
+
+void WavetableSynthesiser::setEventGrid(int numSamples)
+{
+    eventGrid = juce::jmax(1, numSamples);
+}
+
+void WavetableSynthesiser::renderBlock(juce::AudioBuffer<float>& outputAudio, const juce::MidiBuffer& midi, int startSample, int numSamples)
+{
+    // held for the whole block like juce::Synthesiser::renderNextBlock, so notes can't change under the voices
+    const juce::ScopedLock sl(lock);
+
+    const int endSample = startSample + numSamples;
+    int renderedUpTo = startSample;
+
+    for (auto event = midi.begin(); event != midi.end(); ++event)
+    {
+        const auto metadata = *event;
+
+        if (metadata.samplePosition < startSample)
+            continue;
+
+        if (metadata.samplePosition >= endSample)
+            break;
+
+        const auto message = metadata.getMessage();
 
-            // clear current note if ending and env val is very small
-            if (ending)
+        // note ons start exactly where they are, everything else waits for the grid point at or before it
+        int eventSample = metadata.samplePosition;
+
+        if (message.isNoteOff())
+        {
+            // except note offs, which go to the grid point at or after it so gated notes aren't shortened,
+            // but no further than the end of the block or a note on that might play the same note again
+            eventSample = juce::jmin(endSample, startSample + (eventSample - startSample + eventGrid - 1) / eventGrid * eventGrid);
+
+            for (auto next = event; ++next != midi.end() && (*next).samplePosition < eventSample;)
             {
-                if (envVal < 0.0001f)
+                if ((*next).getMessage().isNoteOn())
                 {
-                    clearCurrentNote();
-                    playing = false;
+                    eventSample = (*next).samplePosition;
+                    break;
                 }
             }
         }
-        
-        // calculate cutoff frequency and resonance values with current modulation amount 
-        if (filterCutoffAmp >= 0.0f)
-            currentCutOff = cutoff + filterEnvVal * filterCutoffAmp* (20000.0f - cutoff);
-        else if (filterCutoffAmp < 0.0f)
-            currentCutOff = cutoff + filterEnvVal * filterCutoffAmp * (cutoff - 100.0f);
-
-        if (filterResonanceAmp >= 0.0f)
-            currentResonance = resonance + (filterEnvVal * filterResonanceAmp * (1.0f - resonance));
-        else if (filterResonanceAmp < 0.0f)
-            currentResonance = resonance + (filterEnvVal * filterResonanceAmp * resonance);
-
-        // update the filter with the parameter values plus the envelope modulation
-        ladderFilter.setCutoffFrequencyHz(currentCutOff);
-        ladderFilter.setResonance(currentResonance);
-
-        // apply this filter on the proxy sample block
-        juce::dsp::AudioBlock<float> sampleBlock(proxy);
-        ladderFilter.process(juce::dsp::ProcessContextReplacing<float>(sampleBlock));
-        
-        // add the proxy audio buffer to the output buffer
-        for (int sample = 0; sample < numSamples; ++sample)
+        else if (!message.isNoteOn())
+        {
+            eventSample = startSample + (eventSample - startSample) / eventGrid * eventGrid;
+        }
+
+        // events already passed by an earlier one are handled straight away, keeping them in order
+        if (eventSample > renderedUpTo)
         {
-            for (int channel = 0; channel < proxy.getNumChannels(); channel++)
+            renderVoices(outputAudio, renderedUpTo, eventSample - renderedUpTo);
+            renderedUpTo = eventSample;
+        }
+
+        eventSamplePosition = renderedUpTo;
+        handleMidiEvent(message);
+    }
+
+    eventSamplePosition = 0;
+
+    if (renderedUpTo < endSample)
+        renderVoices(outputAudio, renderedUpTo, endSample - renderedUpTo);
+}
+
+void WavetableSynthesiser::setStealingPolicy(StealingPolicy newPolicy)
+{
+    stealingPolicy = newPolicy;
+}
+
+void WavetableSynthesiser::setVoiceParameters(const VoiceParameters& parameters)
+{
+    voiceParameters = parameters;
+
+    // the mixer ramps are the same for every voice, so the voice bank takes them once
+    voiceBank.setVolumeRamps(voiceParameters.wavetableVolumeRamp, voiceParameters.sineVolumeRamp);
+
+    // voices that start a note later in the block are given the parameters as they start
+    for (int i = 0; i < numActiveVoices; i++)
+        wavetableVoices[activeVoices[i]]->setParameters(voiceParameters);
+}
+
+void WavetableSynthesiser::noteOn(int midiChannel, int midiNoteNumber, float velocity)
+{
+    const juce::ScopedLock sl(lock);
+
+    const int noteSlot = getNoteSlot(midiChannel, midiNoteNumber);
+
+    if (noteSlot < 0)
+        return;
+
+    for (auto* sound : sounds)
+    {
+        if (sound->appliesToNote(midiNoteNumber) && sound->appliesToChannel(midiChannel))
+        {
+            // if hitting a note that's still ringing, stop it first (it could still be playing because of the sustain or sostenuto pedal)
+            if (noteVoices[noteSlot] >= 0)
             {
-                outputBuffer.addSample(channel, startSample, proxy.getSample(channel, sample));
+                const int ringingVoice = noteVoices[noteSlot];
+                unmapNote(ringingVoice);
+                stopVoice(wavetableVoices[ringingVoice], 1.0f, true);
             }
 
-            ++startSample;
+            const int voice = allocateVoice();
+
+            if (voice < 0)
+                return;
+
+            // the voice picks up this block's parameters, and the current wavetables, before it starts
+            wavetableVoices[voice]->setParameters(voiceParameters);
+            startVoice(wavetableVoices[voice], sound, midiChannel, midiNoteNumber, velocity);
+            mapNote(midiChannel, midiNoteNumber, voice);
+
+            // its filter starts from the parameters where the note falls, not at the next control point
+            float smoothedCutoff, smoothedResonance;
+            getSmoothedFilterParameters(eventSamplePosition, smoothedCutoff, smoothedResonance);
+            wavetableVoices[voice]->startFilter(smoothedCutoff, smoothedResonance);
+
+            // and the channel's mod wheel, which juce::Synthesiser only passes on when it moves
+            wavetableVoices[voice]->controllerMoved(1, modWheelValues[midiChannel - 1]);
         }
     }
+}
+
+void WavetableSynthesiser::noteOff(int midiChannel, int midiNoteNumber, float velocity, bool allowTailOff)
+{
+    const juce::ScopedLock sl(lock);
+
+    const int noteSlot = getNoteSlot(midiChannel, midiNoteNumber);
+
+    if (noteSlot < 0 || noteVoices[noteSlot] < 0)
+        return;
 
-   
-    
+    const int voice = noteVoices[noteSlot];
+    auto* v = wavetableVoices[voice];
+
+    jassert(v->getCurrentlyPlayingNote() == midiNoteNumber && v->isPlayingChannel(midiChannel));
+
+    v->setKeyDown(false);
+
+    // a voice held by a pedal stays mapped, so playing the note again stops it
+    if (!(v->isSustainPedalDown() || v->isSostenutoPedalDown()))
+    {
+        unmapNote(voice);
+        stopVoice(v, velocity, allowTailOff);
+    }
 }
 
-//===========================================================================
-// SIMPLE PARAMETER SETTERS
+void WavetableSynthesiser::handleController(int midiChannel, int controllerNumber, int controllerValue)
+{
+    if (controllerNumber == 1 && juce::isPositiveAndBelow(midiChannel - 1, numMidiChannels))
+        modWheelValues[midiChannel - 1] = controllerValue;
+
+    juce::Synthesiser::handleController(midiChannel, controllerNumber, controllerValue);
+}
 
-void WavetableSynthVoice::setWavescanVal(std::atomic<float>* _wavescanBal)
+void WavetableSynthesiser::renderVoices(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples)
 {
-    wavescanBal = *_wavescanBal;
+    if (multiCoreRendering.load(std::memory_order_relaxed) && numActiveVoices >= minVoicesForThreads)
+    {
+        // one job per filter bank group with a voice playing, the groups share nothing so they can run on any thread
+        numActiveGroups = 0;
+
+        for (int i = 0; i < numActiveVoices; i++)
+        {
+            const int group = activeVoices[i] / LadderFilterBank::laneWidth;
+
+            if (!groupListed[group])
+            {
+                groupListed[group] = true;
+                activeGroups[numActiveGroups++] = group;
+            }
+        }
+
+        renderingOutput = &outputAudio;
+        renderingStartSample = startSample;
+        renderingNumSamples = numSamples;
+
+        // the workers are started and stopped on the message thread, until they are running the groups are done here
+        if (!renderPool.run(*this, numActiveGroups))
+            for (int job = 0; job < numActiveGroups; job++)
+                runJob(job, 0);
+
+        for (int i = 0; i < numActiveGroups; i++)
+            groupListed[activeGroups[i]] = false;
+    }
+    else
+    {
+        // the voices playing write their wavetable oscillators into their channels of the filter bank
+        for (int i = 0; i < numActiveVoices; i++)
+        {
+            auto* voice = wavetableVoices[activeVoices[i]];
+            voice->setScratchBuffer(scratchBuffers[0]);
+            voice->renderNextBlock(outputAudio, startSample, numSamples);
+        }
+
+        // envelope, mix and filter them all together, picking up the filter envelope at each control point
+        processControlPeriods(activeVoices, numActiveVoices, -1, startSample, numSamples);
+
+        // then each voice clears its note if it has finished
+        for (int i = 0; i < numActiveVoices; i++)
+            wavetableVoices[activeVoices[i]]->finishBlock();
+    }
+
+    // the control points carry on from where this block leaves off
+    samplesUntilControlPoint = controlRate - (controlRate - samplesUntilControlPoint + numSamples) % controlRate;
+
+    // then pan the filtered voices into the output, always on this thread and in the same order so the sum is the same either way
+    for (int i = 0; i < numActiveVoices; i++)
+        wavetableVoices[activeVoices[i]]->addFilteredBlock(outputAudio, startSample, numSamples);
+
+    // free the voices that finished during this block, backwards as finished voices are swapped out of the list
+    for (int i = numActiveVoices - 1; i >= 0; i--)
+        if (!wavetableVoices[activeVoices[i]]->isVoiceActive())
+            deactivateVoice(activeVoices[i]);
 }
 
-void WavetableSynthVoice::setWavetableVolume(std::atomic<float>* _wavetableVolume)
+void WavetableSynthesiser::runJob(int job, int participant) noexcept
 {
-    wavetableVolume = *_wavetableVolume;
+    const int group = activeGroups[job];
+
+    // the voices of this group that are playing
+    int groupVoices[LadderFilterBank::laneWidth];
+    int numGroupVoices = 0;
+
+    for (int lane = 0; lane < LadderFilterBank::laneWidth; lane++)
+    {
+        const int voice = group * LadderFilterBank::laneWidth + lane;
+
+        if (voice < wavetableVoices.size() && activeVoicePositions[voice] >= 0)
+            groupVoices[numGroupVoices++] = voice;
+    }
+
+    // the same steps as rendering serially, just for this group, with this thread's scratch buffer
+    for (int i = 0; i < numGroupVoices; i++)
+    {
+        auto* voice = wavetableVoices[groupVoices[i]];
+        voice->setScratchBuffer(scratchBuffers[participant]);
+        voice->renderNextBlock(*renderingOutput, renderingStartSample, renderingNumSamples);
+    }
+
+    processControlPeriods(groupVoices, numGroupVoices, group, renderingStartSample, renderingNumSamples);
+
+    for (int i = 0; i < numGroupVoices; i++)
+        wavetableVoices[groupVoices[i]]->finishBlock();
 }
 
-void WavetableSynthVoice::setSineVolume(std::atomic<float>* _sineVolume)
+void WavetableSynthesiser::processControlPeriods(const int* voices, int numVoices, int group, int startSample, int numSamples) noexcept
 {
-    sineVolume = *_sineVolume;
+    const int endSample = startSample + numSamples;
+    int untilControlPoint = samplesUntilControlPoint;
+
+    for (int sample = startSample; sample < endSample;)
+    {
+        // up to the next control point, or the end of the block if that comes first
+        const int length = juce::jmin(untilControlPoint, endSample - sample);
+
+        voiceBank.process(filterBank.getVoiceChannels(), voices, numVoices, sample, length);
+
+        if (group < 0)
+            filterBank.process(sample, length);
+        else
+            filterBank.processGroup(group, sample, length);
+
+        sample += length;
+        untilControlPoint -= length;
+
+        // each filter ramps to its new cutoff and resonance over the next control period
+        if (untilControlPoint == 0)
+        {
+            // the smoothing is the same for every voice, so is only worked out once for the control point
+            float smoothedCutoff, smoothedResonance;
+            getSmoothedFilterParameters(sample - 1, smoothedCutoff, smoothedResonance);
+
+            for (int i = 0; i < numVoices; i++)
+                wavetableVoices[voices[i]]->updateFilter(smoothedCutoff, smoothedResonance);
+
+            untilControlPoint = controlRate;
+        }
+    }
 }
 
-void WavetableSynthVoice::updateADSR(std::atomic<float>* attack, std::atomic<float>* decay, std::atomic<float>* sustain, std::atomic<float>* release)
+void WavetableSynthesiser::getSmoothedFilterParameters(int sample, float& smoothedCutoff, float& smoothedResonance) const noexcept
 {
-    envParams.attack = *attack;
-    envParams.decay = *decay;
-    envParams.sustain = *sustain;
-    envParams.release = *release;
-    env.setParameters(envParams);
+    const auto* ramps = voiceParameters.filterRamps;
+
+    smoothedCutoff = ramps != nullptr ? ramps->getValueAt(ParameterRamps::cutoff, sample) : voiceParameters.cutoff;
+    smoothedResonance = ramps != nullptr ? ramps->getValueAt(ParameterRamps::resonance, sample) : voiceParameters.resonance;
 }
 
+//=================================================================================
+// VOICE ALLOCATION
 
-void WavetableSynthVoice::updateFilter(float _cutoff, float _resonance)
+int WavetableSynthesiser::allocateVoice()
 {
-    cutoff = _cutoff;
-    resonance = _resonance;
+    if (numFreeVoices > 0)
+    {
+        const int voice = freeVoices[--numFreeVoices];
+        activateVoice(voice);
+        return voice;
+    }
+
+    // a stolen voice is still playing, so it stays in the active list and just loses its note
+    const int voice = findVoiceToSteal();
+
+    if (voice >= 0)
+        unmapNote(voice);
+
+    return voice;
 }
 
-void WavetableSynthVoice::updateFilterEnv(std::atomic<float>* filterAttack, std::atomic<float>* filterDecay, std::atomic<float>* filterSustain, std::atomic<float>* filterRelease)
+int WavetableSynthesiser::findVoiceToSteal() const
 {
-    filterEnvParams.attack = *filterAttack;
-    filterEnvParams.decay = *filterDecay;
-    filterEnvParams.sustain = *filterSustain;
-    filterEnvParams.release = *filterRelease;
+    // only reached when every voice is playing, so searching them doesn't slow down ordinary note ons
+    if (stealingPolicy == noStealing)
+        return -1;
+
+    int chosen = -1;
+    bool chosenIsReleased = false;
+
+    for (int i = 0; i < numActiveVoices; i++)
+    {
+        const int voice = activeVoices[i];
+
+        // voices above a lowered polyphony are fading out and are never reused
+        if (voice >= polyphony)
+            continue;
+
+        if (chosen < 0)
+        {
+            chosen = voice;
+            chosenIsReleased = voiceBank.isReleased(voice);
+            continue;
+        }
+
+        const bool isOlder = wavetableVoices[voice]->wasStartedBefore(*wavetableVoices[chosen]);
+
+        switch (stealingPolicy)
+        {
+        case stealOldest:
+            if (isOlder)
+                chosen = voice;
+            break;
+        case stealQuietest:
+            if (voiceBank.getAmplitudeEnvelope(voice) < voiceBank.getAmplitudeEnvelope(chosen))
+                chosen = voice;
+            break;
+        default:
+        {
+            // a released voice always beats a held one, otherwise the older of the two
+            const bool isReleased = voiceBank.isReleased(voice);
 
-    filterEnv.setParameters(filterEnvParams);
+            if ((isReleased && !chosenIsReleased) || (isReleased == chosenIsReleased && isOlder))
+            {
+                chosen = voice;
+                chosenIsReleased = isReleased;
+            }
+            break;
+        }
+        }
+    }
 
+    return chosen;
 }
 
-void WavetableSynthVoice::updateFilterEnvAmp(std::atomic<float>* _filterCutoffAmp, std::atomic<float>* _filterResonanceAmp)
+void WavetableSynthesiser::activateVoice(int voice)
 {
-    filterCutoffAmp = *_filterCutoffAmp;
-    filterResonanceAmp = *_filterResonanceAmp;
+    jassert(activeVoicePositions[voice] < 0);
+
+    activeVoicePositions[voice] = numActiveVoices;
+    activeVoices[numActiveVoices++] = voice;
 }
 
-void WavetableSynthVoice::updateLfo(std::atomic<float>* _lfoFreq, std::atomic<float>* _lfoAmp, std::atomic<float>* _lfoShape)
+void WavetableSynthesiser::deactivateVoice(int voice)
 {
-    lfoAmp = *_lfoAmp;
-    lfoShape = int(*_lfoShape + 1);
-    lfo1.setFrequency(*_lfoFreq);
-    lfo2.setFrequency(*_lfoFreq);
-    lfo3.setFrequency(*_lfoFreq);
-    lfo4.setFrequency(*_lfoFreq);
-}
+    unmapNote(voice);
 
-//=================================================================================
+    // swap the last voice in the list into this one's place
+    const int position = activeVoicePositions[voice];
+    const int lastVoice = activeVoices[--numActiveVoices];
 
-void WavetableSynthVoice::updateWavetable(int index, int slotNumber)
+    activeVoices[position] = lastVoice;
+    activeVoicePositions[lastVoice] = position;
+    activeVoicePositions[voice] = -1;
+
+    // its lane of the filter bank sits out until the voice plays again
+    filterBank.setVoiceActive(voice, false);
+
+    if (voice < polyphony)
+        freeVoices[numFreeVoices++] = voice;
+}
+
+void WavetableSynthesiser::mapNote(int midiChannel, int midiNoteNumber, int voice)
 {
-        
-    // get the data name using this index
-    const char* namedResource = BinaryData::namedResourceList[index];
+    const int noteSlot = getNoteSlot(midiChannel, midiNoteNumber);
+
+    noteVoices[noteSlot] = voice;
+    voiceNoteSlots[voice] = noteSlot;
+}
 
-    // create data size variable
-    int dataSize;
+void WavetableSynthesiser::unmapNote(int voice)
+{
+    const int noteSlot = voiceNoteSlots[voice];
 
-    // using the get named resource function to set the dataSize variable to the size of the data in bytes
-    const char* data = BinaryData::getNamedResource(namedResource, dataSize);
+    if (noteSlot >= 0 && noteVoices[noteSlot] == voice)
+        noteVoices[noteSlot] = -1;
 
-    // use these new data and data size variable to change the wavtable of the specified slot
-    slots[slotNumber]->setWavetable(data, dataSize);
-    
+    voiceNoteSlots[voice] = -1;
 }
 
+int WavetableSynthesiser::getNoteSlot(int midiChannel, int midiNoteNumber) noexcept
+{
+    if (!juce::isPositiveAndBelow(midiChannel - 1, numMidiChannels) || !juce::isPositiveAndBelow(midiNoteNumber, numMidiNotes))
+        return -1;
+
+    return (midiChannel - 1) * numMidiNotes + midiNoteNumber;
+}
@@ -16,8 +16,12 @@
 #include "WavetableOscillator.h"
 #include <BinaryData.h>
 #include "WavescanningSlot.h"
-#include "PluginProcessor.h"
+#include "WavetableBuilder.h"
 #include "Oscillators.h"
+#include "LadderFilterBank.h"
+#include "VoiceBank.h"
+#include "VoiceRenderPool.h"
+#include "ParameterRamps.h"
 
 
 // ===========================
@@ -34,6 +38,74 @@ public:
 
 
 
+// =================================
+// =================================
+// VOICE PARAMETERS
+
+/*!
+ @struct VoiceParameters
+ @abstract values of the synthesiser's parameters shared by every voice
+ @discussion read once per block by the processor, then given to the voices playing and to each voice as it starts a note.
+ Each group of parameters has a change count the processor moves on when one of its values changes, so a voice only
+ recomputes what depends on a group when the count differs from the one it last applied
+
+ @namespace none
+ */
+struct VoiceParameters
+{
+    /// Most recently published tables and morph table from the wavetable builder, the morph table may be null
+    WavescanTables* tables = nullptr;
+    MorphTable* morphTable = nullptr;
+
+    /// Samples of the global lfo for the whole block, or null to use each voice's own note-retriggered lfo
+    const float* globalLfoSamples = nullptr;
+
+    /// Wavescan balance value, between 0 and 4
+    float wavescan = 2.0f;
+
+    /// Per sample smoothed values of the block's audio rate parameters, each null while its parameter is steady
+    const float* wavescanRamp = nullptr;
+    const float* wavetableVolumeRamp = nullptr;
+    const float* sineVolumeRamp = nullptr;
+
+    /// Smoothing of the cutoff and resonance, only read at the control points, null to use them as they are
+    const ParameterRamps* filterRamps = nullptr;
+
+    /// Wavetable and fundamental sinusoidal oscillator volume levels
+    float wavetableVolume = 1.0f, sineVolume = 1.0f;
+
+    /// How far the voices are spread across the stereo field, between 0 and 1
+    float stereoSpread = 0.0f;
+
+    /// Amplitude and filter ADSR envelopes
+    juce::ADSR::Parameters envelope, filterEnvelope;
+
+    /// Filter cutoff frequency in Hz and resonance, before modulation by the filter envelope
+    float cutoff = 10000.0f, resonance = 0.1f;
+
+    /// Amplitudes of the filter envelope's effect on the cutoff frequency and resonance, +ve or -ve
+    float filterCutoffAmp = 0.0f, filterResonanceAmp = 0.0f;
+
+    /// Frequency in Hz, amplitude and shape of the lfo modulating the wavescan position
+    float lfoFreq = 0.5f, lfoAmp = 0.0f;
+    int lfoShape = 0;
+
+    /// Groups of parameters whose derived state is recomputed together
+    enum Group
+    {
+        mixerGroup = 0,         ///< volumes and stereo spread
+        envelopeGroup,          ///< amplitude envelope
+        filterGroup,            ///< cutoff, resonance and the filter envelope amplitudes
+        filterEnvelopeGroup,    ///< filter envelope
+        lfoGroup,               ///< lfo frequency, amplitude and shape
+        numGroups
+    };
+
+    /// Change count of each group, moved on by the processor whenever a value in the group changes
+    juce::uint32 changeCounts[numGroups] = {};
+};
+
+
 // =================================
 // =================================
 // Synthesiser Voice - your synth code goes in here
@@ -58,9 +130,9 @@ public:
     @param midiNoteNumber
     @param velocity
     @param SynthesiserSound unused variable
-    @param / unused variable
+    @param currentPitchWheelPosition pitch wheel position of the note's channel
     */
-    void startNote(int midiNoteNumber, float velocity, juce::SynthesiserSound*, int /*currentPitchWheelPosition*/) override;
+    void startNote(int midiNoteNumber, float velocity, juce::SynthesiserSound*, int currentPitchWheelPosition) override;
     
     //--------------------------------------------------------------------------
     /// Called when a MIDI noteOff message is received
@@ -79,154 +151,214 @@ public:
     //--------------------------------------------------------------------------
     /**
      The Main DSP Block: Put your DSP code in here
-     
-     If the sound that the voice is playing finishes during the course of this rendered block, it must call clearCurrentNote(), to tell the synthesiser that it has finished
+
+     Only renders the wavetable oscillators into the voice's channel, the voice bank then
+     applies the envelope and adds the fundamental for every voice together
 
      @param outputBuffer pointer to output
      @param startSample position of first sample in buffer
      @param numSamples number of smaples in output buffer
      */
     void renderNextBlock(juce::AudioSampleBuffer& outputBuffer, int startSample, int numSamples) override;
-    
+
     //--------------------------------------------------------------------------
-    void pitchWheelMoved(int) override {}
+    /**
+     Add the voice's samples to the output once the filter bank has filtered them
+
+     Does nothing if the voice wasn't playing at the start of the block
+
+     @param outputBuffer pointer to output
+     @param startSample position of first sample in buffer
+     @param numSamples number of smaples in output buffer
+     */
+    void addFilteredBlock(juce::AudioSampleBuffer& outputBuffer, int startSample, int numSamples);
+
     //--------------------------------------------------------------------------
-    void controllerMoved(int, int) override {}
+    /**
+     Update the voice's filter with the filter envelope at a control point
+
+     The voice bank must have processed the voice up to and including the control point,
+     the filter then ramps to the new cutoff and resonance over the next control period
+
+     Does nothing if the voice wasn't playing at the start of the block
+
+     @param smoothedCutoff cutoff frequency in Hz at the control point, before the envelope
+     @param smoothedResonance resonance at the control point, before the envelope
+     */
+    void updateFilter(float smoothedCutoff, float smoothedResonance);
+
     //--------------------------------------------------------------------------
+    /**
+     Set the voice's filter for a note it has just started, straight away rather than at the next control point
+
+     @param smoothedCutoff cutoff frequency in Hz where the note starts, before the envelope
+     @param smoothedResonance resonance where the note starts, before the envelope
+     */
+    void startFilter(float smoothedCutoff, float smoothedResonance);
 
+    //--------------------------------------------------------------------------
     /**
-     Can this voice play a sound. I wouldn't worry about this for the time being
+     Finish off the block once the voice bank has processed every voice
 
-     @param sound a juce::SynthesiserSound* base class pointer
-     @return sound cast as a pointer to an instance of YourSynthSound
+     If the sound has finished calls clearCurrentNote(), to tell the synthesiser that it has finished
+
+     Does nothing if the voice wasn't playing at the start of the block
      */
-    bool canPlaySound (juce::SynthesiserSound* sound) override
-    {
-        return dynamic_cast<WavetableSynthSound*> (sound) != nullptr;
-    }
+    void finishBlock();
 
+    //--------------------------------------------------------------------------
     /**
-     Modify the mix between the wavetables
+     Give the voice its channel of the synthesiser's filter bank and its state in the voice bank
 
-     @param wavescan balance value
+     @param filter bank shared by all the voices
+     @param voice bank shared by all the voices
+     @param index of this voice's channel and filter in the filter bank, and its state in the voice bank
      */
-    void setWavescanVal(std::atomic<float>* _wavescanBal);
+    void setBanks(LadderFilterBank* _filterBank, VoiceBank* _voiceBank, int index);
 
+    //--------------------------------------------------------------------------
     /**
-    Sets the volume of the wavetable oscillator
+     Give the voice the buffer it renders its oscillators into, shared with the other voices
 
-    @param wavetable oscillator volume level
-    */
-    void setWavetableVolume(std::atomic<float>* _wavetableVolume);
+     @param buffer with numScratchChannels channels of at least a block's worth of samples
+     */
+    void setScratchBuffer(juce::AudioBuffer<float>* _scratchBuffer);
+
+    /// Channels of the scratch buffer used by a voice: one per slot, then the wavescan positions and the morph oscillator
+    static constexpr int numScratchChannels = WavescanTables::numSlots + 2;
+    
+    //--------------------------------------------------------------------------
+    /**
+     Bend the pitch of the note, up to pitchBendRange semitones either way
+
+     Only remembered here, the oscillators are retuned once at the start of the next block rendered
+     however many times the wheel moved in between
 
+     @param new pitch wheel position, 0 to 16383 with 8192 in the centre
+     */
+    void pitchWheelMoved(int newPitchWheelValue) override;
+
+    //--------------------------------------------------------------------------
     /**
-    Sets the volume of the sinusoidal fundamental oscillator
+     Respond to a controller on the note's channel, the mod wheel (CC 1) scans up through the wavetables
 
-    @param fundamental sinusoidal oscillator volume level
-    */
-    void setSineVolume(std::atomic<float>* _sineVolume);
+     @param controller number
+     @param new controller value, 0 to 127
+     */
+    void controllerMoved(int controllerNumber, int newControllerValue) override;
+
+    /// Number of semitones the pitch wheel bends the note by at either end of its travel
+    static constexpr float pitchBendRange = 2.0f;
+
+    //--------------------------------------------------------------------------
 
     /**
-    Update the parameters of the ADSR envelope
+     Can this voice play a sound. I wouldn't worry about this for the time being
 
-    @param attack time in seconds
-    @param decay time in seconds
-    @param sustain value between 0 and 1
-    @param release time in seconds
-    */
-    void updateADSR(std::atomic<float>* attack, std::atomic<float>* decay, std::atomic<float>* sustain, std::atomic<float>* release);
+     @param sound a juce::SynthesiserSound* base class pointer
+     @return sound cast as a pointer to an instance of YourSynthSound
+     */
+    bool canPlaySound (juce::SynthesiserSound* sound) override
+    {
+        return dynamic_cast<WavetableSynthSound*> (sound) != nullptr;
+    }
 
     /**
-    update the current filter parameters before modulation by the ADSR envelope
+     Update the voice with the values of the synthesiser's parameters
 
-    @param cutoff frequency in Hz
-    @param resonance value, between 0 and 1
-    */
-    void updateFilter(float cutoff, float resonance); 
+     Called every block while the voice is playing, and just before it starts a note.
+     Only recomputes the envelope rates, lfo increment and mixer state whose parameters have changed
+
+     @param values of the parameters for this block
+     */
+    void setParameters(const VoiceParameters& parameters);
 
     /**
-    Update the parameters of the filter ADSR envelope
+     Give the voice the wavetables currently loaded into the wavescanner slots
 
-    @param attack time in seconds
-    @param decay time in seconds
-    @param sustain value between 0 and 1
-    @param release time in seconds
-    */
-    void updateFilterEnv(std::atomic<float>* filterAttack, std::atomic<float>* filterDecay, std::atomic<float>* filterSustain, std::atomic<float>* filterRelease);
+     If they have changed while a note is playing the voice crossfades
+     from the old wavetables to the new ones
 
+     @param most recently published tables from the wavetable builder
+     */
+    void setWavescanTables(WavescanTables* tables);
+
+private:
+    //--------------------------------------------------------------------------
     /**
-    Update the values of the amplitude for the filter ADSR envelope
+     Set where the voice sits in the stereo field
 
-    @param filter cutoff frequency envelope amplitude, +ve or -ve
-    @param filter resonance envelope amplitude, +ve or -ve
-    */
-    void updateFilterEnvAmp(std::atomic<float>* _filterCutoffAmp, std::atomic<float>* _filterResonanceAmp);
+     @param pan position, -1 is hard left, 0 centre and 1 hard right
+     */
+    void setPan(float pan);
 
     /**
-    Update the parameters of the low frequency oscillator that modulates wavescanning value
+     Find the lower of the two slots a wavescan position falls between
 
-    @param frequency of the LFO in Hz
-    @param amplitude of the oscillation
-    @param integer for determining which LFO is currently in use
-    */
-    void updateLfo(std::atomic<float>* _lfoFreq, std::atomic<float>* _lfoAmp, std::atomic<float>* _lfoShape);
+     @param wavescan position between 0 and 4
+     */
+    int getLowerSlot(float wavescanPosition) const noexcept;
 
     /**
-     Change the wavetable stored in a specified slot of the wavescanner
+     Can the baked morph table be played this block instead of morphing live
+     */
+    bool canPlayMorphTable() const noexcept;
 
-     @param index number used to obtain wavetable from binary data
-     @param slot number of the wavescanner to be changed
+    /**
+     Get the frequency of the note bent by the pitch wheel
      */
-    void updateWavetable(int index, int slotNumber);
+    float getBentFrequency() const noexcept;
 
+    /// Work out the cutoff and resonance modulated by the filter envelope as it is now
+    void calculateFilterParameters(float smoothedCutoff, float smoothedResonance);
 
-private:
     //--------------------------------------------------------------------------
     /// Should the voice be playing?
     bool playing = false;
-
-    /// Is the voice in the process of ending?
-    bool ending = false;
     
     //==========================================================================
     
     /// Number of wavescanning slots
     const int wavescanningSlotsNumber = 5;
 
-    /// First slot of the wavescanner, instance of the WavescanningSlot class
-    WavescanningSlot slotOne;
+    /// Wavetables currently loaded into the five slots of the wavescanner
+    WavescanTables::Ptr currentTables;
 
-    /// Second slot of the wavescanner, instance of the WavescanningSlot class
-    WavescanningSlot slotTwo;
+    /// Wavetables being crossfaded out of after a slot was changed mid note
+    WavescanTables::Ptr previousTables;
 
-    /// Third slot of the wavescanner, instance of the WavescanningSlot class
-    WavescanningSlot slotThree;
+    /// Samples left before the crossfade out of the previous wavetables is finished
+    int tableCrossfadeRemaining = 0;
 
-    /// Fourth slot of the wavescanner, instance of the WavescanningSlot class
-    WavescanningSlot slotFour;
+    /// Length of the crossfade when the wavetable in a slot is changed mid note
+    static constexpr int tableCrossfadeSamples = 512;
 
-    /// Fifth slot of the wavescanner, instance of the WavescanningSlot class
-    WavescanningSlot slotFive;
-    
-    /// Pointer array to the five slots of the wavescanner 
-    WavescanningSlot* slots[5] = { &slotOne, &slotTwo, &slotThree, &slotFour, &slotFive };
+    /// Which antialiased octave of the wavetables the current note is using
+    int currentWavetable = 0;
 
-    /// Owned arrays of WavetableOscillators
-    juce::OwnedArray<WavetableOscillator> wtOscillatorOne;
-    juce::OwnedArray<WavetableOscillator> wtOscillatorTwo;
-    juce::OwnedArray<WavetableOscillator> wtOscillatorThree;
-    juce::OwnedArray<WavetableOscillator> wtOscillatorFour;
-    juce::OwnedArray<WavetableOscillator> wtOscillatorFive;
+    /// Frequency of the note in Hz before any pitch bend
+    float noteFrequency = 440.0f;
 
-    //==========================================================================
+    /// Pitch wheel position of the note's channel, and whether it has moved since the oscillators were last tuned
+    int pitchWheelPosition = 8192;
+    bool pitchWheelChanged = false;
 
-    /// Simple sinusoidal oscillator for playing the fundamental frequency
-    SinOsc fundamentalOsc;
+    /// Mod wheel position between 0 and 1, added to the wavescan position across the whole range of slots
+    float modWheel = 0.0f;
 
-    //==========================================================================
+    /// One WavetableOscillator per slot, reused for every note so note on never allocates
+    WavetableOscillator wtOscillators[WavescanTables::numSlots];
+
+    /// Latest morph table from the wavetable builder, only valid for the current block
+    MorphTable* availableMorphTable = nullptr;
+
+    /// Morph table the morph oscillator is playing, null while morphing live
+    MorphTable::Ptr playingMorphTable;
+
+    /// Oscillator for playing the baked morph table, kept in phase with the slot oscillators
+    WavetableOscillator morphOscillator;
 
-    /// The ADSR envelope
-    juce::ADSR env;
+    //==========================================================================
 
     /// Gain used in process block to reduce volume
     float gain = 0.2f;
@@ -240,33 +372,41 @@ private:
     /// Sine oscillator volume level, update from the atomic float
     float sineVolume = 1.0f;
 
-    /// Current sample variable used in the process bloack
-    float currentSample = 0.0f;
-    
     /// For storing the parmeters of the ADSR envelope
     juce::ADSR::Parameters envParams;
 
-    /// Moog style ladder filter from the JUCE DSP module
-    juce::dsp::LadderFilter<float> ladderFilter;
+    /// Moog style ladder filter bank shared by every voice, owned by the synthesiser
+    LadderFilterBank* filterBank = nullptr;
+
+    /// Envelopes, fundamental oscillator and mixer of every voice, owned by the synthesiser
+    VoiceBank* voiceBank = nullptr;
+
+    /// Index of this voice's channel and filter in the filter bank, and its state in the voice bank
+    int bankIndex = 0;
 
-    /// ADSR envelope for modulating the filter parameters
-    juce::ADSR filterEnv;
+    /// Did the voice write to its filter bank channel during the current block
+    bool renderedThisBlock = false;
 
     /// For storing the parameters of the filter ADSR envelope
     juce::ADSR::Parameters filterEnvParams;
 
-    /// Audio buffer used to store voice samples seperate from output buffer so filtering can be applied
-    juce::AudioBuffer<float> voiceBuffer;
+    /// Gain of the voice in the left and right channels of a stereo output
+    float panGains[2] = { 1.0f, 1.0f };
+
+    /// Where the voice sits in the stereo field at full stereo spread, between -1 and 1
+    float panPosition = 0.0f;
+
+    /// Change count of each parameter group last applied to the voice, a count the processor never uses until applied
+    juce::uint32 appliedChangeCounts[VoiceParameters::numGroups];
+
+    /// Buffer the oscillators render a block into, shared by the voices as only one renders at a time
+    juce::AudioBuffer<float>* scratchBuffer = nullptr;
 
     //===========================
     // some variables used for the filter which require global scope 
 
-    /// variable for storing cutoff frequency
-    float cutoff = 10000.0f;
     /// variable for storing cutoff frequency plus envelope amount
     float currentCutOff = 10000.0f;
-    /// variable for storing resonance
-    float resonance = 0.1f;
     /// variable for storing resonance plus envelope amount
     float currentResonance = 0.1f;
 
@@ -278,26 +418,293 @@ private:
     float filterResonanceAmp = 0.0f;
     //===========================
 
-    /// LFO Shape 1 - Sinusoidal
-    SinOsc lfo1;
+    /// Block rate LFO, one shape at a time selected by the lfo_shape parameter
+    BlockLfo lfo;
 
-    /// LFO Shape 2 - Triangle
-    TriOsc lfo2;
-    
-    /// LFO Shape 3 - Saw
-    Phasor lfo3;
-    
-    /// LFO Shape 4 - Square
-    SquareOsc lfo4;
+    /// Global LFO samples for the current block, null when the voice uses its own LFO
+    const float* globalLfoSamples = nullptr;
+
+    /// Smoothed wavescan for the current block, null while the parameter is steady
+    const float* wavescanRamp = nullptr;
 
     //===========================
     // some variables used for the LFO which require global scope 
 
-    /// integer used to determine which lfo shape is currently selected
-    int lfoShape = 1;
-    /// current sample acquired from the LFO
-    float lfoSample = 0.0f;
     /// current amplitude of the LFO
     float lfoAmp = 0.0f;
     //===========================
 };
+
+
+// =================================
+// =================================
+// SYNTHESISER
+
+/*!
+ @class WavetableSynthesiser
+ @abstract juce::Synthesiser that allocates voices in constant time and filters all of its voices together
+ @discussion note on and note off find their voice from a free list and a map of the notes playing instead
+ of searching every voice, and only the voices playing are rendered, so idle voices cost nothing per block.
+ With multi-core rendering on, the voices are rendered on a pool of worker threads, a filter bank group
+ of voices per job, and then added to the output in the same order as when rendering serially
+
+ @namespace none
+ */
+class WavetableSynthesiser : public juce::Synthesiser,
+                             private VoiceRenderPool::Jobs,
+                             private juce::Timer
+{
+public:
+    /// Number of voices to add to the synthesiser, the most the polyphony can be set to
+    static constexpr int maxVoices = 256;
+
+    /// Which voice to take over when a note starts and every voice is in use
+    enum StealingPolicy
+    {
+        stealReleasedFirst = 0, ///< the oldest released voice, or the oldest voice if none have been released
+        stealOldest,            ///< the voice that started its note longest ago
+        stealQuietest,          ///< the voice with the lowest amplitude envelope
+        noStealing              ///< no voice is stolen and the new note is not played
+    };
+
+    WavetableSynthesiser();
+
+    //--------------------------------------------------------------------------
+    /**
+     Set the sample rate and set up the filter and voice banks for the voices, call after all the voices have been added
+
+     @param sample rate
+     @param maximum number of samples in a block
+     */
+    void prepare(double sampleRate, int samplesPerBlock);
+
+    //--------------------------------------------------------------------------
+    /**
+     Set how many voices can play at once, voices above a lowered polyphony are released
+
+     @param number of voices, between 1 and the number of voices added
+     */
+    void setPolyphony(int newPolyphony);
+
+    //--------------------------------------------------------------------------
+    /**
+     Turn rendering the voices on the worker threads on or off
+
+     Even when on, blocks with fewer than minVoicesForThreads voices playing are rendered
+     serially, as they don't have enough work to make waking the workers worthwhile. The
+     workers are only running while this is on, started and stopped on the message thread
+
+     @param true to spread the voices across the worker threads
+     */
+    void setMultiCoreRendering(bool shouldRenderOnWorkers);
+
+    /// Fewest voices playing for a block to be rendered on the worker threads
+    static constexpr int minVoicesForThreads = 16;
+
+    //--------------------------------------------------------------------------
+    /**
+     Set how often the filter envelope updates the voices' filters
+
+     The control points fall every so many samples from when the synthesiser was prepared,
+     whatever the size of the host's blocks, and the filters ramp between them
+
+     @param number of samples between control points, such as 16, 32 or 64
+     */
+    void setControlRate(int numSamples);
+
+    //--------------------------------------------------------------------------
+    /**
+     Set the grid midi events other than note ons are moved onto when rendering with renderBlock
+
+     Dense controller and pitch bend streams then split a block into at most one
+     render per grid cell, rather than one per event. Note ons stay sample accurate,
+     and note offs are moved later rather than earlier so notes are never cut short
+
+     @param number of samples between grid points, 1 to keep every event sample accurate
+     */
+    void setEventGrid(int numSamples);
+
+    //--------------------------------------------------------------------------
+    /**
+     Render a block, handling its midi events on the event grid
+
+     Used in place of renderNextBlock, which splits the block at every event. A note off
+     is handled at the grid point at or after it, but no later than the next note on or
+     the end of the block, any other event apart from a note on at the grid point at or
+     before it, and the voices are rendered between the points events are handled at
+
+     @param outputAudio buffer to add the voices to
+     @param midi events for the block
+     @param startSample position of first sample in buffer
+     @param numSamples number of samples to render
+     */
+    void renderBlock(juce::AudioBuffer<float>& outputAudio, const juce::MidiBuffer& midi, int startSample, int numSamples);
+
+    //--------------------------------------------------------------------------
+    /**
+     Set which voice is stolen when a note starts and every voice is in use
+
+     @param voice stealing policy
+     */
+    void setStealingPolicy(StealingPolicy newPolicy);
+
+    //--------------------------------------------------------------------------
+    /**
+     Update the voices playing with this block's parameter values, which voices starting a note later pick up too
+
+     @param values of the parameters for this block
+     */
+    void setVoiceParameters(const VoiceParameters& parameters);
+
+    //--------------------------------------------------------------------------
+    /**
+     Start a note on a free or stolen voice, stopping the same note first if it is still ringing
+
+     @param midi channel, 1 to 16
+     @param midi note number
+     @param velocity
+     */
+    void noteOn(int midiChannel, int midiNoteNumber, float velocity) override;
+
+    //--------------------------------------------------------------------------
+    /**
+     Release the voice playing a note, unless a pedal is holding it
+
+     @param midi channel, 1 to 16
+     @param midi note number
+     @param velocity
+     @param allowTailOff bool to decide if there should be any volume decay
+     */
+    void noteOff(int midiChannel, int midiNoteNumber, float velocity, bool allowTailOff) override;
+
+    //--------------------------------------------------------------------------
+    /**
+     Pass a controller on to the voices playing on its channel, remembering the mod wheel for notes started later
+
+     @param midi channel, 1 to 16
+     @param controller number
+     @param controller value, 0 to 127
+     */
+    void handleController(int midiChannel, int controllerNumber, int controllerValue) override;
+
+protected:
+    //--------------------------------------------------------------------------
+    /**
+     Render the voices playing, finish them all in the voice bank, filter them all in the filter bank and add them to the output
+
+     @param outputAudio buffer to add the voices to
+     @param startSample position of first sample in buffer
+     @param numSamples number of samples to render
+     */
+    void renderVoices(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples) override;
+
+private:
+    //--------------------------------------------------------------------------
+    /// Render, envelope, mix and filter the voices playing in one filter bank group, run by the worker threads
+    void runJob(int job, int participant) noexcept override;
+
+    /// Start or stop the worker threads to follow the multi-core setting, on the message thread
+    void timerCallback() override;
+
+    /**
+     Envelope, mix and filter a list of voices one control period at a time, updating their filters at each control point
+
+     @param indices of the voices to process
+     @param number of voices in the list
+     @param filter bank group the voices are all in, or -1 to filter every group
+     @param first sample to process
+     @param number of samples to process
+     */
+    void processControlPeriods(const int* voices, int numVoices, int group, int startSample, int numSamples) noexcept;
+
+    /// Get the cutoff and resonance at a sample of the block, where their smoothing has got to
+    void getSmoothedFilterParameters(int sample, float& smoothedCutoff, float& smoothedResonance) const noexcept;
+
+    /// Take a voice from the free list, or steal one, returns -1 if there is none
+    int allocateVoice();
+
+    /// Pick the voice to steal with the current policy, returns -1 if there is none
+    int findVoiceToSteal() const;
+
+    /// Add a voice to the list of voices playing
+    void activateVoice(int voice);
+
+    /// Remove a voice that has finished from the list of voices playing, and free it if it is within the polyphony
+    void deactivateVoice(int voice);
+
+    /// Remember which voice is playing a note
+    void mapNote(int midiChannel, int midiNoteNumber, int voice);
+
+    /// Forget the note a voice was playing, if it is still the voice mapped to it
+    void unmapNote(int voice);
+
+    /// Index into the note map of a channel and note, -1 for a channel outside 1 to 16
+    static int getNoteSlot(int midiChannel, int midiNoteNumber) noexcept;
+
+    //--------------------------------------------------------------------------
+    /// Ladder filters for every voice, processed a group of voices at a time
+    LadderFilterBank filterBank;
+
+    /// Envelopes, fundamental oscillators and mixers of every voice, processed a chunk of samples at a time
+    VoiceBank voiceBank;
+
+    /// The voices, already cast, in the same order as their filter bank channels and voice bank states
+    juce::Array<WavetableSynthVoice*> wavetableVoices;
+
+    /// Buffers the voices render their oscillators into, one for each thread that can render a voice
+    juce::OwnedArray<juce::AudioBuffer<float>> scratchBuffers;
+
+    /// Worker threads the voices are rendered on in multi-core mode
+    VoiceRenderPool renderPool;
+
+    /// Is multi-core rendering turned on, set on the audio thread and followed by the timer on the message thread
+    std::atomic<bool> multiCoreRendering { false };
+
+    /// Number of worker threads the pool is started with, one for each spare core
+    int numWorkers = 0;
+
+    /// Samples between control points, and samples left until the next one at the start of the next block
+    int controlRate = 32;
+    int samplesUntilControlPoint = 32;
+
+    /// Samples between the grid points midi events other than note ons are handled at
+    int eventGrid = 16;
+
+    /// Sample of the block the midi event being handled by renderBlock falls on
+    int eventSamplePosition = 0;
+
+    /// Filter bank groups with a voice playing, one job each, and whether each group is already in the list
+    int activeGroups[maxVoices];
+    bool groupListed[maxVoices] = {};
+    int numActiveGroups = 0;
+
+    /// Block being rendered by the worker threads
+    juce::AudioBuffer<float>* renderingOutput = nullptr;
+    int renderingStartSample = 0, renderingNumSamples = 0;
+
+    /// Parameter values for the current block
+    VoiceParameters voiceParameters;
+
+    /// Number of voices allowed to play at once, and the policy for stealing one when they all are
+    int polyphony = 10;
+    StealingPolicy stealingPolicy = stealReleasedFirst;
+
+    /// Stack of voices free to start a note, the next one to use on top
+    int freeVoices[maxVoices];
+    int numFreeVoices = 0;
+
+    /// Voices playing a note in no particular order, and where each voice is in that list, -1 if it isn't playing
+    int activeVoices[maxVoices];
+    int activeVoicePositions[maxVoices];
+    int numActiveVoices = 0;
+
+    /// Voice playing each note of each midi channel, -1 for none
+    static constexpr int numMidiChannels = 16, numMidiNotes = 128;
+    int noteVoices[numMidiChannels * numMidiNotes];
+
+    /// Note map slot each voice is mapped to, -1 for none
+    int voiceNoteSlots[maxVoices];
+
+    /// Last mod wheel value on each midi channel, given to voices as they start
+    int modWheelValues[numMidiChannels] = {};
+};
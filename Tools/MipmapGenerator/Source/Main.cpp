@@ -0,0 +1,237 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Part of WavemorpherSynthesizer project
+
+    Created: 17th October 2026
+    Author:  agent
+
+    Description: Command line tool that writes Source/FactoryMipmaps.cpp.
+    Every factory wavetable is embedded in this tool's BinaryData exactly as
+    it is in the plugin's, and for each of FactoryMipmaps::sampleRates the
+    tool decodes it and builds its octaves with the plugin's own
+    MipmapBuilder, then writes them out as aligned static float arrays.
+
+    It can also pack a folder of single cycle audio files into a
+    WavetableLibrary, for the plugin to map at start up.
+
+    Usage: MipmapGenerator <path to Source/FactoryMipmaps.cpp>
+           MipmapGenerator --library <library file> <folder of wavetables>
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <BinaryData.h>
+#include "../../../Source/FactoryMipmaps.h"
+#include "../../../Source/MipmapBuilder.h"
+#include "../../../Source/WavetableOscillator.h"
+#include "../../../Source/WavetableLibrary.h"
+
+//------------------------------------------------------------------------------
+/**
+ Decode a wavetable from BinaryData the same way WavescanningSlot does
+
+ @param wav file data
+ @param size of the data in bytes
+ @param buffer to decode the wavetable into
+ @return true if anything was decoded
+ */
+static bool decodeWavetable(const char* data, int dataSize, juce::AudioBuffer<float>& wavetable)
+{
+    juce::WavAudioFormat wavFormat;
+    std::unique_ptr<juce::AudioFormatReader> reader(wavFormat.createReaderFor(new juce::MemoryInputStream(data, (size_t)dataSize, false), true));
+
+    if (reader == nullptr)
+        return false;
+
+    wavetable.setSize((int)reader->numChannels, (int)reader->lengthInSamples);
+    reader->read(&wavetable, 0, (int)reader->lengthInSamples, 0, true, true);
+
+    return wavetable.getNumSamples() > 1;
+}
+
+//------------------------------------------------------------------------------
+/**
+ Write one octave as an aligned static array
+
+ @param stream to write to
+ @param name of the array
+ @param samples of the octave, guard samples included
+ @param number of samples
+ */
+static void writeOctave(juce::OutputStream& out, const juce::String& name, const float* samples, int numSamples)
+{
+    out << "alignas(alignment) static const float " << name << "[" << numSamples << "] =\n{";
+
+    for (int i = 0; i < numSamples; i++)
+    {
+        // nine significant figures is enough for every float to come back exactly as it was written
+        char number[32];
+        std::snprintf(number, sizeof(number), "%.9g", (double)samples[i]);
+
+        out << (i % 8 == 0 ? "\n    " : " ") << number << "f" << (i < numSamples - 1 ? "," : "");
+    }
+
+    out << "\n};\n\n";
+}
+
+//------------------------------------------------------------------------------
+/**
+ Write the octaves of every factory wavetable as C++ source
+
+ @param file to write, only touched if its contents would change
+ @return exit code
+ */
+static int writeFactoryMipmaps(const juce::File& outputFile)
+{
+    juce::MemoryOutputStream out;
+
+    out << "/*\n"
+        << "  ==============================================================================\n\n"
+        << "    FactoryMipmaps.cpp\n"
+        << "    Part of WavemorpherSynthesizer project\n\n"
+        << "    Generated by Tools/MipmapGenerator from the factory wavetables, do not edit\n\n"
+        << "  ==============================================================================\n"
+        << "*/\n\n"
+        << "#include \"FactoryMipmaps.h\"\n"
+        << "#include \"MipmapBuilder.h\"\n"
+        << "#include \"WavetableOscillator.h\"\n\n";
+
+    // the plugin checks that the settings the octaves were built with still match its own
+    out << "static_assert(WavetableOscillator::numGuardSamples == " << WavetableOscillator::numGuardSamples
+        << ", \"guard samples have changed, run the MipmapGenerator again\");\n"
+        << "static_assert(MipmapBuilder::minTableSize == " << MipmapBuilder::minTableSize
+        << ", \"minimum table size has changed, run the MipmapGenerator again\");\n"
+        << "static_assert(MipmapBuilder::bendHeadroom == " << juce::String(MipmapBuilder::bendHeadroom, 1)
+        << "f, \"bend headroom has changed, run the MipmapGenerator again\");\n\n"
+        << "namespace FactoryMipmaps\n{\n\n";
+
+    juce::StringArray pyramidEntries;
+
+    for (int rateIndex = 0; rateIndex < FactoryMipmaps::numSampleRates; rateIndex++)
+    {
+        const double sampleRate = FactoryMipmaps::sampleRates[rateIndex];
+        const int rateInHz = juce::roundToInt(sampleRate);
+
+        for (int index = 0; index < BinaryData::namedResourceListSize; index++)
+        {
+            const char* resourceName = BinaryData::namedResourceList[index];
+
+            int dataSize;
+            const char* data = BinaryData::getNamedResource(resourceName, dataSize);
+
+            juce::AudioBuffer<float> wavetable;
+
+            if (!decodeWavetable(data, dataSize, wavetable))
+            {
+                std::cout << "Couldn't decode " << BinaryData::originalFilenames[index] << ", it will be built at run time" << std::endl;
+                continue;
+            }
+
+            juce::AudioBuffer<float> octaves[FactoryMipmaps::numOctaves];
+            MipmapBuilder(sampleRate).build(wavetable.getReadPointer(0), wavetable.getNumSamples(), octaves, FactoryMipmaps::numOctaves);
+
+            out << "// " << BinaryData::originalFilenames[index] << " at " << rateInHz << "Hz\n";
+
+            juce::StringArray octaveNames, octaveLengths;
+
+            for (int octave = 0; octave < FactoryMipmaps::numOctaves; octave++)
+            {
+                const auto name = juce::String(resourceName) + "_" + juce::String(rateInHz) + "_" + juce::String(octave);
+                writeOctave(out, name, octaves[octave].getReadPointer(0), octaves[octave].getNumSamples());
+
+                octaveNames.add(name);
+                octaveLengths.add(juce::String(octaves[octave].getNumSamples() - WavetableOscillator::numGuardSamples));
+            }
+
+            pyramidEntries.add("    { \"" + juce::String(resourceName) + "\", " + juce::String(rateInHz) + ".0,\n"
+                               + "      { " + octaveNames.joinIntoString(", ") + " },\n"
+                               + "      { " + octaveLengths.joinIntoString(", ") + " } }");
+        }
+    }
+
+    out << "const Pyramid pyramids[] =\n{\n"
+        << pyramidEntries.joinIntoString(",\n") << "\n"
+        << "};\n\n"
+        << "const int numPyramids = " << pyramidEntries.size() << ";\n\n"
+        << "}\n";
+
+    // only touch the file when something has changed, so the plugin isn't rebuilt for nothing
+    if (outputFile.existsAsFile() && outputFile.loadFileAsString() == out.toString())
+    {
+        std::cout << outputFile.getFullPathName() << " is up to date" << std::endl;
+        return 0;
+    }
+
+    if (!outputFile.replaceWithData(out.getData(), out.getDataSize()))
+    {
+        std::cout << "Couldn't write " << outputFile.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    std::cout << "Wrote " << pyramidEntries.size() << " pyramids to " << outputFile.getFullPathName() << std::endl;
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+ Pack every audio file in a folder into a wavetable library, each file taken as one cycle
+
+ @param library file to write
+ @param folder searched for audio files, subfolders included
+ @return exit code
+ */
+static int writeLibrary(const juce::File& libraryFile, const juce::File& folder)
+{
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    juce::StringArray names;
+    juce::Array<juce::AudioBuffer<float>> cycles;
+
+    for (const auto& entry : juce::RangedDirectoryIterator(folder, true, formatManager.getWildcardForAllFormats()))
+    {
+        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(entry.getFile()));
+
+        if (reader == nullptr || reader->lengthInSamples < 2 || reader->lengthInSamples > WavetableLibrary::maxCycleLength)
+        {
+            std::cout << "Skipping " << entry.getFile().getFullPathName() << std::endl;
+            continue;
+        }
+
+        // only the first channel is used, the same as the factory tables
+        juce::AudioBuffer<float> cycle(1, (int)reader->lengthInSamples);
+        reader->read(&cycle, 0, (int)reader->lengthInSamples, 0, true, false);
+
+        names.add(entry.getFile().getFileNameWithoutExtension());
+        cycles.add(cycle);
+    }
+
+    // built for the lowest sample rate the plugin generates for, so the octaves play unchanged at every common rate
+    if (!WavetableLibrary::write(libraryFile, FactoryMipmaps::sampleRates[0], names, cycles))
+    {
+        std::cout << "Couldn't write " << libraryFile.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    std::cout << "Wrote " << juce::jmin(names.size(), WavetableLibrary::maxTables) << " wavetables to " << libraryFile.getFullPathName() << std::endl;
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    const auto workingDirectory = juce::File::getCurrentWorkingDirectory();
+
+    if (argc == 2)
+        return writeFactoryMipmaps(workingDirectory.getChildFile(argv[1]));
+
+    if (argc == 4 && juce::String(argv[1]) == "--library")
+        return writeLibrary(workingDirectory.getChildFile(argv[2]), workingDirectory.getChildFile(argv[3]));
+
+    std::cout << "Usage: MipmapGenerator <path to Source/FactoryMipmaps.cpp>" << std::endl
+              << "       MipmapGenerator --library <library file> <folder of wavetables>" << std::endl;
+    return 1;
+}